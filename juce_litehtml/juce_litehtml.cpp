@@ -4,6 +4,10 @@
 
 #include "juce_litehtml.h"
 
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+
 using namespace juce;
 
 #include "webengine/master_css.cpp"
@@ -13,7 +17,14 @@ using namespace juce;
 #include "webengine/webloader.cpp"
 #include "webengine/webcontext.cpp"
 #include "webengine/webpage.cpp"
+#include "webengine/displaylist.cpp"
+#include "webengine/tilerenderer.cpp"
+#include "webengine/textwidthcache.cpp"
+#include "webengine/scaledimagecache.cpp"
+#include "webengine/renderer.cpp"
+#include "webengine/framescheduler.cpp"
 #include "webengine/webview.cpp"
+#include "webengine/headlessrenderer.cpp"
 
 #include "webengine/el_script.cpp"
 #include "webengine/el_input.cpp"
@@ -40,6 +40,7 @@ extern "C" {
 #include "webengine/webcontext.h"
 #include "webengine/webpage.h"
 #include "webengine/webview.h"
+#include "webengine/headlessrenderer.h"
 
 #include "webengine/el_script.h"
 #include "webengine/el_input.h"
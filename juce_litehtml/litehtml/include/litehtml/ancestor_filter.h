@@ -0,0 +1,80 @@
+#ifndef LH_ANCESTOR_FILTER_H
+#define LH_ANCESTOR_FILTER_H
+
+#include <vector>
+#include "atoms.h"
+
+namespace litehtml
+{
+	class element;
+
+	// Counting Bloom filter of the tags, ids and classes of the ancestors of
+	// the element being styled.
+	//
+	// The style pass pushes an element before styling its children and pops it
+	// afterwards. A selector needing an ancestor with a tag, id or class missing
+	// from the filter cannot match, so it is rejected without walking the tree.
+	// The filter can report false positives, never false negatives.
+	class ancestor_filter
+	{
+	public:
+		enum key_kind
+		{
+			key_tag = 1,
+			key_id,
+			key_class,
+		};
+
+	private:
+		enum
+		{
+			key_bits		= 12,
+			counters_count	= 1 << key_bits,
+			key_mask		= counters_count - 1,
+		};
+
+		struct entry
+		{
+			const element*	el;
+			size_t			first_key;
+		};
+
+		unsigned char		m_counters[counters_count] = {};
+		std::vector<unsigned int>	m_keys;
+		std::vector<entry>	m_entries;
+	public:
+		// Starts the keys of the element, added with add()
+		void				push(const element* el);
+		void				add(unsigned int key);
+		void				pop();
+		void				clear();
+
+		// Innermost element in the filter, nullptr if the filter is empty
+		const element*		top() const		{ return m_entries.empty() ? nullptr : m_entries.back().el;	}
+
+		bool				may_contain(unsigned int key) const
+		{
+			return m_counters[key & key_mask] && m_counters[(key >> key_bits) & key_mask];
+		}
+
+		bool				may_contain_all(const std::vector<unsigned int>& keys) const
+		{
+			for(unsigned int k : keys)
+			{
+				if(!may_contain(k))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		static unsigned int	key(atom name, key_kind kind)
+		{
+			unsigned long long h = ((unsigned long long) (uintptr_t) name + (unsigned long long) kind) * 0x9E3779B97F4A7C15ull;
+			return (unsigned int) (h >> 32);
+		}
+	};
+}
+
+#endif  // LH_ANCESTOR_FILTER_H
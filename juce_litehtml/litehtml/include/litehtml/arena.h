@@ -0,0 +1,88 @@
+#ifndef LH_ARENA_H
+#define LH_ARENA_H
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+namespace litehtml
+{
+	// Bump allocator for the document nodes.
+	//
+	// Memory is handed out from large blocks. A deallocated chunk goes to the
+	// free list of its size and is reused by the next allocation of that size,
+	// as the nodes replaced on restyles or DOM changes get the same sizes; the
+	// blocks themselves are released together when the arena is destroyed.
+	// The nodes are created and destroyed on the document thread, so the arena
+	// is not synchronized.
+	class arena
+	{
+	public:
+		typedef std::shared_ptr<arena>	ptr;
+
+		explicit arena(size_t block_size = 64 * 1024);
+		~arena();
+
+		arena(const arena&) = delete;
+		arena& operator=(const arena&) = delete;
+
+		void*	allocate(size_t size, size_t align);
+		void	deallocate(void* p, size_t size, size_t align);
+
+		size_t	bytes_allocated() const	{ return m_bytes_allocated;	}
+		size_t	bytes_reserved() const	{ return m_bytes_reserved;	}
+		size_t	blocks_count() const	{ return m_blocks.size();	}
+
+	private:
+		std::vector<char*>	m_blocks;
+		size_t				m_block_size;
+		char*				m_cur;
+		char*				m_end;
+		size_t				m_bytes_allocated;
+		size_t				m_bytes_reserved;
+		std::vector<void*>	m_free;		// chunks freed, by size in granules
+
+		// the sizes of the reused chunks are rounded up to this, and so is their alignment
+		static const size_t	granule = 16;
+
+		static size_t	chunk_size(size_t size)	{ return size ? (size + granule - 1) / granule * granule : granule; }
+		char*	add_block(size_t size);
+	};
+
+	// Standard allocator on top of the arena, to be used with std::allocate_shared.
+	// The arena is kept alive by the allocator copies, so it is released
+	// together with the last node allocated from it.
+	template<class T>
+	class arena_allocator
+	{
+	public:
+		typedef T	value_type;
+
+		explicit arena_allocator(const arena::ptr& a) : m_arena(a) {}
+
+		template<class U>
+		arena_allocator(const arena_allocator<U>& other) : m_arena(other.get_arena()) {}
+
+		T* allocate(size_t n)
+		{
+			return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T* p, size_t n)
+		{
+			m_arena->deallocate(p, n * sizeof(T), alignof(T));
+		}
+
+		const arena::ptr&	get_arena() const	{ return m_arena; }
+
+		template<class U>
+		bool operator==(const arena_allocator<U>& other) const	{ return m_arena == other.get_arena(); }
+		template<class U>
+		bool operator!=(const arena_allocator<U>& other) const	{ return m_arena != other.get_arena(); }
+
+	private:
+		arena::ptr	m_arena;
+	};
+}
+
+#endif  // LH_ARENA_H
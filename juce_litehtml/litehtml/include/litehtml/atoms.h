@@ -0,0 +1,91 @@
+#ifndef LH_ATOMS_H
+#define LH_ATOMS_H
+
+#include <deque>
+#include <unordered_map>
+#include "os_types.h"
+
+namespace litehtml
+{
+	// Interned name (tag, attribute name, id or class).
+	//
+	// Equal strings are interned to the same atom, so the atoms are compared
+	// as integers. The atom points to the interned string, nullptr is the
+	// empty atom.
+	typedef const tstring* atom;
+
+	// Table of the atoms.
+	//
+	// Each context owns a table, the atoms are released with the context.
+	// A string is looked up in the parent tables first, so the atoms of a
+	// shared master stylesheet match the names of the context documents.
+	// The predefined table is the root of all the tables.
+	//
+	// A table is not synchronized: it is only changed by the thread using
+	// its context, and the parent tables are never changed once shared.
+	class atom_table
+	{
+		// Looked up string, hashed once for all the tables of the chain
+		struct key
+		{
+			const tchar_t*	str;
+			size_t			len;
+			size_t			hash;
+
+			key(const tchar_t* s, size_t l);
+			bool operator==(const key& val) const;
+		};
+
+		struct key_hash
+		{
+			size_t operator()(const key& k) const	{ return k.hash; }
+		};
+
+		const atom_table*							m_parent;
+		std::deque<tstring>							m_strings;	// never moved, so their addresses are the atoms
+		std::unordered_map<key, atom, key_hash>		m_names;	// the keys point to m_strings
+
+		atom_table(const atom_table* parent, const tchar_t* names);
+
+		atom			find(const key& k) const;
+		atom			intern(const key& k);
+	public:
+		atom_table();
+		atom_table(const atom_table&) = delete;
+		atom_table& operator=(const atom_table&) = delete;
+
+		// Parent table, nullptr for the predefined table
+		void			set_parent(const atom_table* parent);
+
+		// Returns the atom of the string, adding it to the table.
+		// The empty string is the empty atom.
+		atom			intern(const tstring& str);
+		atom			intern(const tchar_t* str);
+		// Returns the atom of the string, or nullptr if it has never been interned
+		atom			find(const tstring& str) const;
+		atom			find(const tchar_t* str) const;
+		size_t			size() const	{ return m_names.size(); }
+
+		// Names used by litehtml itself, shared by all the threads
+		static const atom_table&	predefined();
+	};
+
+	inline const tchar_t* atom_str(atom a)
+	{
+		return a ? a->c_str() : _t("");
+	}
+
+	inline atom atom_id()
+	{
+		static const atom a = atom_table::predefined().find(_t("id"));
+		return a;
+	}
+
+	inline atom atom_class()
+	{
+		static const atom a = atom_table::predefined().find(_t("class"));
+		return a;
+	}
+}
+
+#endif  // LH_ATOMS_H
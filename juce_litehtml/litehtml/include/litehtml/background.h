@@ -15,6 +15,7 @@ namespace litehtml
 	public:
 		tstring					m_image;
 		tstring					m_baseurl;
+		uint_ptr				m_image_handle;
 		web_color				m_color;
 		background_attachment	m_attachment;
 		css_position			m_position;
@@ -36,6 +37,7 @@ namespace litehtml
 	public:
 		tstring					image;
 		tstring					baseurl;
+		uint_ptr				image_handle;
 		background_attachment	attachment;
 		background_repeat		repeat;
 		web_color				color;
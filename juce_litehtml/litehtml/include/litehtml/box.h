@@ -114,6 +114,7 @@ namespace litehtml
 	private:
 		bool						have_last_space() const;
 		bool						is_break_only() const;
+		void						merge_fragments();
 	};
 }
 
@@ -65,10 +65,19 @@ namespace litehtml
 		JSValue js_eval(const litehtml::tstring& script);
 
 		void			load_master_stylesheet(const tchar_t* str);
-		litehtml::css&	master_css() { return m_master_css; }
+		/** Use a master stylesheet parsed once, it can be shared by any number of contexts and threads.
+			It must be set before the documents get created, as its atoms are used by the documents names. */
+		void			set_master_stylesheet(const std::shared_ptr<const litehtml::css>& css);
+		const litehtml::css&	master_css() const { return *m_master_css; }
+		/** Atoms of the names used by the documents and the stylesheets of the context. */
+		atom_table&		atoms() { return m_atoms; }
 		JSRuntime*		js_runtime() { return m_jsRuntime; }
 		JSContext*		js_context() { return m_jsContext; }
 
+		/** Allocate the nodes of the documents created afterwards from a per-document arena. */
+		void			set_use_arena(bool val) { m_use_arena = val; }
+		bool			use_arena() const { return m_use_arena; }
+
 		/** Register JS prototype method. */
     	static void js_register_method(JSContext* ctx, JSValue prototype, const tchar_t* name, JSCFunction func);
 
@@ -81,11 +90,16 @@ namespace litehtml
     	/** Register JS protptype property. */
     	static void js_register_property(JSContext* ctx, JSValue prototype, const tchar_t* name, JSGetter getter, JSSetter setter = nullptr);
 
+		/** Parse and sort a master stylesheet, the result is never modified. */
+		static std::shared_ptr<const litehtml::css> parse_master_stylesheet(const tchar_t* str);
+
 	private:
 
-		litehtml::css	m_master_css;
+		std::shared_ptr<const litehtml::css>	m_master_css;
+		atom_table		m_atoms;
 		JSRuntime*		m_jsRuntime;
 		JSContext*		m_jsContext;
+		bool			m_use_arena;
 
 		/** Register default classes. */
 		void js_register_default_classes();
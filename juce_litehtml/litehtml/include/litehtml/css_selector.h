@@ -3,6 +3,7 @@
 
 #include "style.h"
 #include "media_query.h"
+#include "ancestor_filter.h"
 
 namespace litehtml
 {
@@ -134,14 +135,17 @@ namespace litehtml
 	{
 		typedef std::vector<css_attribute_selector>	vector;
 
-		tstring					attribute;
+		atom					attribute;
 		tstring					val;
-		string_vector			class_val;
+		atom					val_atom;	// lower case id
+		std::vector<atom>		class_val;	// lower case class names
 		attr_select_condition	condition;
 
 		css_attribute_selector()
 		{
-			condition = select_exists;
+			attribute	= nullptr;
+			val_atom	= nullptr;
+			condition	= select_exists;
 		}
 	};
 
@@ -150,11 +154,12 @@ namespace litehtml
 	class css_element_selector
 	{
 	public:
-		tstring							m_tag;
+		atom							m_tag;		// nullptr for any tag
 		css_attribute_selector::vector	m_attrs;
 	public:
 
-		void parse(const tstring& txt);
+		// The names are interned into atoms
+		void parse(const tstring& txt, atom_table& atoms);
 	};
 
 	//////////////////////////////////////////////////////////////////////////
@@ -183,6 +188,8 @@ namespace litehtml
 		int						m_order;
 		media_query_list::ptr	m_media_query;
 		tstring					m_baseurl;
+		std::vector<unsigned int>	m_ancestor_keys;	// ancestor_filter keys of the ancestors the selector needs
+		bool					m_sibling_dependent;	// the match depends on the element position among its siblings
 	public:
 		explicit css_selector(const media_query_list::ptr& media, const tstring& baseurl)
 		{
@@ -190,6 +197,7 @@ namespace litehtml
 			m_baseurl		= baseurl;
 			m_combinator	= combinator_descendant;
 			m_order			= 0;
+			m_sibling_dependent	= false;
 		}
 
 		~css_selector() = default;
@@ -208,10 +216,14 @@ namespace litehtml
 			m_specificity	= val.m_specificity;
 			m_order			= val.m_order;
 			m_media_query	= val.m_media_query;
+			m_ancestor_keys	= val.m_ancestor_keys;
+			m_sibling_dependent	= val.m_sibling_dependent;
 		}
 
-		bool parse(const tstring& text);
+		bool parse(const tstring& text, atom_table& atoms);
 		void calc_specificity();
+		void calc_ancestor_keys();
+		void calc_sibling_dependence();
 		bool is_media_valid() const;
 		void add_media_to_doc(document* doc) const;
 	};
@@ -4,6 +4,7 @@
 #include "style.h"
 #include "types.h"
 #include "context.h"
+#include "arena.h"
 
 namespace litehtml
 {
@@ -32,6 +33,20 @@ namespace litehtml
 		}
 	};
 
+	// Counters of the style pass, accumulated over the document life
+	struct style_stats
+	{
+		size_t	selectors_tested	= 0;	// candidate selectors matched against the elements
+		size_t	filter_checked		= 0;	// candidates needing ancestors, looked up in the ancestor filter
+		size_t	filter_rejected		= 0;	// candidates rejected by the ancestor filter
+		size_t	styles_shared		= 0;	// elements that took the style of a sibling instead of matching
+
+		double filter_rejection_rate() const
+		{
+			return filter_checked ? (double) filter_rejected / (double) filter_checked : 0.0;
+		}
+	};
+
 	class html_tag;
 
 	class document : public std::enable_shared_from_this<document>
@@ -63,9 +78,17 @@ namespace litehtml
 		litehtml::context*					m_context;
 		litehtml::size						m_size;
 		position::vector					m_fixed_boxes;
+		elements_vector						m_fixed_elements;
+		elements_vector						m_lazy_images;
+		bool								m_draw_fixed;
+		bool								m_scrolled_fixed;
 		media_query_list::vector			m_media_lists;
 		element::ptr						m_over_element;
+		element::ptr						m_hit_element;
+		position							m_hit_region;
+		position							m_hit_origin;
 		elements_vector						m_tabular_elements;
+		elements_vector						m_spare_fragments;
 		media_features						m_media;
 		tstring                             m_lang;
 		tstring                             m_culture;
@@ -74,6 +97,11 @@ namespace litehtml
 
 		std::vector<litehtml::element::ptr> m_stashed_elements;
 
+		arena::ptr							m_arena;
+		ancestor_filter						m_ancestor_filter;
+		style_stats							m_style_stats;
+		std::vector<const html_tag*>*		m_style_siblings;
+
 	public:
 		document(litehtml::document_container* objContainer, litehtml::context* ctx);
 		virtual ~document();
@@ -84,7 +112,9 @@ namespace litehtml
 		litehtml::css&					get_styles() { return m_styles; }
 		uint_ptr						get_font(const tchar_t* name, int size, const tchar_t* weight, const tchar_t* style, const tchar_t* decoration, font_metrics* fm);
 		int								render(int max_width, render_type rt = render_all);
-		void							draw(uint_ptr hdc, int x, int y, const position* clip);
+		void							draw(uint_ptr hdc, int x, int y, const position* clip, render_type rt = render_all);
+		void							draw_fixed_element(uint_ptr hdc, const element::ptr& el, int x, int y, const position* clip);
+		bool							is_drawn_separately(const element::ptr& el) const;
 		web_color						get_def_color()	{ return m_def_color; }
 		int								cvt_units(const tchar_t* str, int fontSize, bool* is_percent = nullptr) const;
 		int								cvt_units(css_length& val, int fontSize, int size = 0) const;
@@ -99,6 +129,14 @@ namespace litehtml
 		element::ptr					root();
 		void							get_fixed_boxes(position::vector& fixed_boxes);
 		void							add_fixed_box(const position& pos);
+		const elements_vector&			get_fixed_elements() const { return m_fixed_elements; }
+		void							add_fixed_element(const element::ptr& el);
+		// true when some fixed elements are stacked under other content and drawn along with it
+		bool							has_scrolled_fixed() const { return m_scrolled_fixed; }
+		void							add_lazy_image(const element::ptr& el);
+		bool							load_lazy_images(const position& area);
+		void							get_image_size(uint_ptr image, const tchar_t* src, const tchar_t* baseurl, size& sz);
+		bool							has_lazy_images() const { return !m_lazy_images.empty(); }
 		void							add_media_list(const media_query_list::ptr& list);
 		bool							media_changed();
 		bool							lang_changed();
@@ -109,6 +147,29 @@ namespace litehtml
 		void                            append_children_from_string(element& parent, const tchar_t* str);
 		void                            append_children_from_utf8(element& parent, const char* str);
 
+		/** Create a document node, from the document arena when there is one. */
+		template<class T, class... Args>
+		std::shared_ptr<T>				make_element(Args&&... args)
+		{
+			if(m_arena)
+			{
+				return std::allocate_shared<T>(arena_allocator<T>(m_arena), std::forward<Args>(args)...);
+			}
+			return std::make_shared<T>(std::forward<Args>(args)...);
+		}
+		const arena::ptr&				get_arena() const { return m_arena; }
+
+		/** Layout fragments of the text runs, kept for reuse by any run. */
+		elements_vector&				spare_fragments() { return m_spare_fragments; }
+
+		/** Ancestors of the element being styled, maintained by the style pass. */
+		ancestor_filter&				get_ancestor_filter() { return m_ancestor_filter; }
+		style_stats&					get_style_stats() { return m_style_stats; }
+		const style_stats&				get_style_stats() const { return m_style_stats; }
+		/** Siblings recently styled by the same pass, set by the parent for the next child it styles. */
+		void							set_style_siblings(std::vector<const html_tag*>* siblings) { m_style_siblings = siblings; }
+		std::vector<const html_tag*>*	get_style_siblings() const { return m_style_siblings; }
+
 		void							stash_element(litehtml::element::ptr el);
 		void							remove_from_stash(litehtml::element::ptr el);
 
@@ -119,6 +180,9 @@ namespace litehtml
 		litehtml::uint_ptr	add_font(const tchar_t* name, int size, const tchar_t* weight, const tchar_t* style, const tchar_t* decoration, font_metrics* fm);
 
 		void create_node(void* gnode, elements_vector& elements, bool parseTextNode);
+		element::ptr get_element_by_point(int x, int y, int client_x, int client_y);
+		void cache_hit_element(const element::ptr& el);
+		bool find_scrolled_fixed(const element::ptr& el) const;
 		bool update_media_lists(const media_features& features);
 		void fix_tables_layout();
 		void fix_table_children(element::ptr& el_ptr, style_display disp, const tchar_t* disp_str);
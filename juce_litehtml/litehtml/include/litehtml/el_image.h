@@ -9,6 +9,8 @@ namespace litehtml
 	class el_image : public html_tag
 	{
 		tstring	m_src;
+		uint_ptr	m_image_handle;
+		bool	m_image_requested;
 	public:
 		el_image(const std::shared_ptr<litehtml::document>& doc);
 		virtual ~el_image(void);
@@ -20,8 +22,11 @@ namespace litehtml
 		virtual void	parse_styles(bool is_reparse = false) override;
 		virtual void	draw(uint_ptr hdc, int x, int y, const position* clip) override;
 		virtual void	get_content_size(size& sz, int max_width) override;
+		virtual void	load_deferred_image() override;
 	private:
 		int calc_max_height(int image_height);
+		bool is_lazy() const;
+		void request_image();
 	};
 }
 
@@ -18,8 +18,12 @@ namespace litehtml
 		el_text(const tchar_t* text, const std::shared_ptr<litehtml::document>& doc);
 
 		void				get_text(tstring& text) override;
+		const tchar_t*		get_draw_text() const override;
+		const tchar_t*		get_style_property(css_property id, bool inherited, const tchar_t* def = nullptr) const override;
 		const tchar_t*		get_style_property(const tchar_t* name, bool inherited, const tchar_t* def = nullptr) const override;
 		void				parse_styles(bool is_reparse) override;
+		bool				parse_text_styles(std::vector<const tchar_t*>& texts) override;
+		void				set_text_widths(const int* widths) override;
 		int					get_base_line() override;
 		void				draw(uint_ptr hdc, int x, int y, const position* clip) override;
 		int					line_height() const override;
@@ -0,0 +1,97 @@
+#ifndef LH_EL_TEXT_RUN_H
+#define LH_EL_TEXT_RUN_H
+
+#include "html_tag.h"
+#include "el_text.h"
+
+namespace litehtml
+{
+	class el_text_run;
+
+	// Words of a text run laid out together.
+	// Fragments are not part of the document tree, they are the line box items of the run.
+	class el_text_fragment : public el_text
+	{
+		friend class el_text_run;
+
+		el_text_run*	m_run;
+		size_t			m_first;	// first word of the fragment
+		size_t			m_last;		// last word of the fragment
+		size_t			m_run_id;
+	public:
+		el_text_fragment(el_text_run* run, const std::shared_ptr<litehtml::document>& doc);
+
+		bool				is_white_space() const override;
+		bool				is_break() const override;
+		bool				is_space() const override;
+		const tchar_t*		get_draw_text() const override;
+		void				draw(uint_ptr hdc, int x, int y, const position* clip) override;
+		bool				is_first_fragment(const element* run) const override;
+		bool				is_last_fragment(const element* run) const override;
+		bool				merge_fragment(const element::ptr& el) override;
+
+	protected:
+		void				get_content_size(size& sz, int max_width) override;
+	};
+
+	// Text node stored as a single string with the word boundaries.
+	// The words get placed into the line boxes as fragments, the adjacent
+	// fragments of a line are merged after the line is finished.
+	// A run of a single word is placed itself, as a plain text element.
+	class el_text_run : public el_text
+	{
+		friend class el_text_fragment;
+
+		struct text_word
+		{
+			unsigned int	offset;			// in m_text, the words are null terminated
+			unsigned int	draw_offset;	// in m_transformed_text
+			int				width;
+			bool			space;
+			bool			placed;			// has been placed by the last layout
+		};
+
+		std::vector<text_word>		m_words;
+		elements_vector				m_fragments;
+		size_t						m_first_solid;
+		size_t						m_last_solid;
+	public:
+		el_text_run(const std::shared_ptr<litehtml::document>& doc);
+
+		void				add_word(const tchar_t* text, bool space);
+		bool				empty() const { return m_words.empty(); }
+
+		void				get_text(tstring& text) override;
+		const tchar_t*		get_draw_text() const override;
+		bool				parse_text_styles(std::vector<const tchar_t*>& texts) override;
+		void				set_text_widths(const int* widths) override;
+		bool				is_white_space() const override;
+		bool				is_break() const override;
+		bool				is_space() const override;
+		bool				is_text_run() const override;
+		bool				have_inline_child() const override;
+		int					render_inline(const element::ptr& container, int max_width) override;
+		size_t				get_fragments_count() const override;
+		element::ptr		get_fragment(size_t idx) const override;
+		void				draw(uint_ptr hdc, int x, int y, const position* clip) override;
+		bool				is_point_inside(int x, int y) override;
+		void				calc_document_size(litehtml::size& sz, int x = 0, int y = 0) override;
+		void				get_redraw_box(litehtml::position& pos, int x = 0, int y = 0) override;
+		position			build_spatial_index() override;
+
+	protected:
+		void				get_content_size(size& sz, int max_width) override;
+
+	private:
+		static bool			collapse_spaces(white_space ws);
+		bool				is_white_space_word(size_t idx, white_space ws) const;
+		bool				is_break_word(size_t idx, white_space ws) const;
+		const tchar_t*		get_word_text(size_t idx, white_space ws) const;
+		int					get_words_width(size_t first, size_t last) const;
+		element::ptr		new_fragment(size_t idx);
+		bool				merge_fragments(el_text_fragment* frag, const element::ptr& el);
+		void				draw_words(uint_ptr hdc, int x, int y, const position* clip, const position& words_pos, size_t first, size_t last, size_t run_id);
+	};
+}
+
+#endif  // LH_EL_TEXT_RUN_H
@@ -38,6 +38,8 @@ namespace litehtml
 	protected:
 		std::weak_ptr<element>		m_parent;
 		std::weak_ptr<litehtml::document>	m_doc;
+		element*					m_parent_ptr;		// non-owning links for the hot paths,
+		litehtml::document*			m_doc_ptr;			// valid while the parent/document is alive
 		litehtml::box*				m_box;
 		elements_vector				m_children;
 		position					m_pos;
@@ -97,7 +99,7 @@ namespace litehtml
 		margins						get_borders()				const;
 
 		bool						in_normal_flow()			const;
-		litehtml::web_color			get_color(const tchar_t* prop_name, bool inherited, const litehtml::web_color& def_color = litehtml::web_color());
+		litehtml::web_color			get_color(css_property prop, bool inherited, const litehtml::web_color& def_color = litehtml::web_color());
 		bool						is_inline_box()				const;
 		position					get_placement()				const;
 		bool						collapse_top_margin()		const;
@@ -108,6 +110,7 @@ namespace litehtml
 		void						skip(bool val);
 		bool						have_parent() const;
 		element::ptr				parent() const;
+		element*					parent_ptr() const;
 		void						parent(const element::ptr& par);
 		bool						is_visible() const;
 		int							calc_width(int defVal) const;
@@ -118,6 +121,7 @@ namespace litehtml
 		bool						is_table_skip() const;
 
 		std::shared_ptr<document>	get_document() const;
+		document*					document_ptr() const;
 
 		element::ptr				get_parent() const;
 
@@ -162,6 +166,7 @@ namespace litehtml
 		virtual void				set_attr(const tchar_t* name, const tchar_t* val);
 		virtual const tchar_t*		get_attr(const tchar_t* name, const tchar_t* def = nullptr) const;
 		virtual void				apply_stylesheet(const litehtml::css& stylesheet);
+		virtual void				add_ancestor_keys(ancestor_filter& filter) const;
 		virtual void				refresh_styles();
 		virtual bool				is_white_space() const;
         virtual bool                is_space() const;
@@ -188,12 +193,18 @@ namespace litehtml
 		virtual element_position	get_element_position(css_offsets* offsets = nullptr) const;
 		virtual void				get_inline_boxes(position::vector& boxes);
 		virtual void				parse_styles(bool is_reparse = false);
+		virtual bool				parse_text_styles(std::vector<const tchar_t*>& texts);
+		virtual void				set_text_widths(const int* widths);
+		virtual void				load_deferred_image();
 		virtual void				draw(uint_ptr hdc, int x, int y, const position* clip);
 		virtual void				draw_background( uint_ptr hdc, int x, int y, const position* clip );
+		virtual const tchar_t*		get_style_property(css_property id, bool inherited, const tchar_t* def = nullptr) const;
 		virtual const tchar_t*		get_style_property(const tchar_t* name, bool inherited, const tchar_t* def = nullptr) const;
+		virtual const computed_style::ptr&	get_computed_style() const;
 		virtual uint_ptr			get_font(font_metrics* fm = nullptr);
 		virtual int					get_font_size() const;
 		virtual void				get_text(tstring& text);
+		virtual const tchar_t*		get_draw_text() const;
 		virtual void				parse_attributes();
 		virtual int					select(const css_selector& selector, bool apply_pseudo = true);
 		virtual int					select(const css_element_selector& selector, bool apply_pseudo = true);
@@ -204,6 +215,12 @@ namespace litehtml
 		virtual bool				is_first_child_inline(const element::ptr& el) const;
 		virtual bool				is_last_child_inline(const element::ptr& el);
 		virtual bool				have_inline_child() const;
+		virtual bool				is_text_run() const;
+		virtual size_t				get_fragments_count() const;
+		virtual element::ptr		get_fragment(size_t idx) const;
+		virtual bool				is_first_fragment(const element* run) const;
+		virtual bool				is_last_fragment(const element* run) const;
+		virtual bool				merge_fragment(const element::ptr& el);
 		virtual void				get_content_size(size& sz, int max_width);
 		virtual void				init();
 		virtual bool				is_floats_holder() const;
@@ -226,6 +243,9 @@ namespace litehtml
 		virtual bool				get_predefined_height(int& p_height) const;
 		virtual void				calc_document_size(litehtml::size& sz, int x = 0, int y = 0);
 		virtual void				get_redraw_box(litehtml::position& pos, int x = 0, int y = 0);
+		virtual position			build_spatial_index();
+		virtual bool				has_child_at_point(int x, int y) const;
+		virtual bool				is_overlapped(const position& region, const element* target, const std::vector<const element*>& ancestors) const;
 		virtual void				add_style(const tstring& style, const tstring& baseurl);
 		virtual element::ptr		get_element_by_point(int x, int y, int client_x, int client_y);
 		virtual element::ptr		get_child_by_point(int x, int y, int client_x, int client_y, draw_flag flag, int zindex);
@@ -367,7 +387,7 @@ namespace litehtml
 
 	inline bool litehtml::element::have_parent() const
 	{
-		return !m_parent.expired();
+		return m_parent_ptr != nullptr;
 	}
 
 	inline element::ptr litehtml::element::parent() const
@@ -375,9 +395,15 @@ namespace litehtml
 		return m_parent.lock();
 	}
 
+	inline element* litehtml::element::parent_ptr() const
+	{
+		return m_parent_ptr;
+	}
+
 	inline void litehtml::element::parent(const element::ptr& par)
 	{
 		m_parent = par;
+		m_parent_ptr = par.get();
 	}
 
 	inline int litehtml::element::margin_top() const
@@ -431,6 +457,11 @@ namespace litehtml
 		return m_doc.lock();
 	}
 
+	inline document* element::document_ptr() const
+	{
+		return m_doc_ptr;
+	}
+
 	inline element::ptr element::get_parent() const
 	{
 		return m_parent.lock();
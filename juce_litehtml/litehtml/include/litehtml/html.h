@@ -12,6 +12,8 @@
 #include <functional>
 #include "os_types.h"
 #include "types.h"
+#include "atoms.h"
+#include "keywords.h"
 #include "background.h"
 #include "borders.h"
 #include "html_tag.h"
@@ -38,13 +40,17 @@ namespace litehtml
 		virtual litehtml::uint_ptr	create_font(const litehtml::tchar_t* faceName, int size, int weight, litehtml::font_style italic, unsigned int decoration, litehtml::font_metrics* fm) = 0;
 		virtual void				delete_font(litehtml::uint_ptr hFont) = 0;
 		virtual int					text_width(const litehtml::tchar_t* text, litehtml::uint_ptr hFont) = 0;
+		virtual void				text_widths(const litehtml::tchar_t* const* texts, size_t count, litehtml::uint_ptr hFont, int* widths);
 		virtual void				draw_text(litehtml::uint_ptr hdc, const litehtml::tchar_t* text, litehtml::uint_ptr hFont, litehtml::web_color color, const litehtml::position& pos) = 0;
+		virtual void				draw_text_run(litehtml::uint_ptr hdc, const litehtml::text_run& run, litehtml::uint_ptr hFont, litehtml::web_color color, const litehtml::position& pos);
 		virtual int					pt_to_px(int pt) const = 0;
 		virtual int					get_default_font_size() const = 0;
 		virtual const litehtml::tchar_t*	get_default_font_name() const = 0;
 		virtual void				draw_list_marker(litehtml::uint_ptr hdc, const litehtml::list_marker& marker) = 0;
 		virtual void				load_image(const litehtml::tchar_t* src, const litehtml::tchar_t* baseurl, bool redraw_on_ready) = 0;
 		virtual void				get_image_size(const litehtml::tchar_t* src, const litehtml::tchar_t* baseurl, litehtml::size& sz) = 0;
+		virtual litehtml::uint_ptr	resolve_image(const litehtml::tchar_t* src, const litehtml::tchar_t* baseurl);
+		virtual void				get_resolved_image_size(litehtml::uint_ptr image, litehtml::size& sz);
 		virtual void				draw_background(litehtml::uint_ptr hdc, const litehtml::background_paint& bg) = 0;
 		virtual void				draw_borders(litehtml::uint_ptr hdc, const litehtml::borders& borders, const litehtml::position& draw_pos, bool root) = 0;
 
@@ -58,6 +64,8 @@ namespace litehtml
 		virtual void				import_script(litehtml::tstring& text, const litehtml::tstring& url) = 0;
 		virtual void				set_clip(litehtml::uint_ptr hdc, const litehtml::position& pos, const litehtml::border_radiuses& bdr_radius, bool valid_x, bool valid_y) = 0;
 		virtual void				del_clip(litehtml::uint_ptr hdc) = 0;
+		virtual void				begin_fixed(litehtml::uint_ptr /*hdc*/) {}
+		virtual void				end_fixed(litehtml::uint_ptr /*hdc*/) {}
 		virtual void				get_client_rect(litehtml::position& client) const = 0;
 		virtual std::shared_ptr<litehtml::element>	create_element(const litehtml::tchar_t *tag_name,
 																	 const litehtml::string_map &attributes,
@@ -66,6 +74,7 @@ namespace litehtml
 		virtual void				get_media_features(litehtml::media_features& media) const = 0;
 		virtual void				get_language(litehtml::tstring& language, litehtml::tstring & culture) const = 0;
 		virtual litehtml::tstring resolve_color(const litehtml::tstring& /*color*/) const { return litehtml::tstring(); }
+		virtual bool				lazy_load_images() const { return false; }
 		virtual void				split_text(const char* text, const std::function<void(const tchar_t*)>& on_word, const std::function<void(const tchar_t*)>& on_space);
 
 	protected:
@@ -76,6 +85,25 @@ namespace litehtml
 	void lcase(tstring &s);
 	int	 value_index(const tstring& val, const tstring& strings, int defValue = -1, tchar_t delim = _t(';'));
 	bool value_in_list(const tstring& val, const tstring& strings, tchar_t delim = _t(';'));
+
+	template<size_t N>
+	int value_index(const tchar_t* val, const keyword_table<N>& keywords, int defValue = -1)
+	{
+		return keywords.find(val, defValue);
+	}
+
+	template<size_t N>
+	int value_index(const tstring& val, const keyword_table<N>& keywords, int defValue = -1)
+	{
+		return keywords.find(val, defValue);
+	}
+
+	template<size_t N>
+	bool value_in_list(const tstring& val, const keyword_table<N>& keywords)
+	{
+		return keywords.find(val) >= 0;
+	}
+
 	tstring::size_type find_close_bracket(const tstring &s, tstring::size_type off, tchar_t open_b = _t('('), tchar_t close_b = _t(')'));
 	void split_string(const tstring& str, string_vector& tokens, const tstring& delims, const tstring& delims_preserve = _t(""), const tstring& quote = _t("\""));
 	void join_string(tstring& str, const string_vector& tokens, const tstring& delims);
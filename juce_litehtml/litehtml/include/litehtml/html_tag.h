@@ -10,6 +10,7 @@
 #include "stylesheet.h"
 #include "box.h"
 #include "table.h"
+#include "spatial_index.h"
 
 namespace litehtml
 {
@@ -30,6 +31,9 @@ namespace litehtml
 		}
 	};
 
+	// Number of the recently styled siblings an element may share its style with
+	const size_t style_sharing_candidates = 4;
+
 	class html_tag : public element
 	{
 		friend class elements_iterator;
@@ -42,10 +46,14 @@ namespace litehtml
 
 	protected:
 		box::vector				m_boxes;
-		string_vector			m_class_values;
-		tstring					m_tag;
+		std::vector<atom>		m_class_values;		// lower case class names
+		atom					m_id;				// lower case id
+		atom					m_tag;
 		litehtml::style			m_style;
-		string_map				m_attrs;
+		computed_style::ptr		m_computed;
+		bool					m_style_shareable;	// no rule matched so far depends on the element position or pseudo elements
+		const html_tag*			m_shared_style;		// sibling whose style was taken by the last pass, until parse_styles
+		std::vector<std::pair<atom, tstring>>	m_attrs;
 		vertical_align			m_vertical_align;
 		text_align				m_text_align;
 		style_display			m_display;
@@ -63,6 +71,9 @@ namespace litehtml
 		bool					m_lh_predefined;
 		string_vector			m_pseudo_classes;
 		used_selector::vector	m_used_styles;
+		spatial_index			m_children_index;
+		std::vector<text_run>	m_text_runs;
+		int_vector				m_children_runs;
 
 		uint_ptr				m_font;
 		int						m_font_size;
@@ -143,7 +154,9 @@ namespace litehtml
 
 		void				set_attr(const tchar_t* name, const tchar_t* val) override;
 		const tchar_t*		get_attr(const tchar_t* name, const tchar_t* def = nullptr) const override;
+		const tchar_t*		get_attr(atom name, const tchar_t* def = nullptr) const;
 		void				apply_stylesheet(const litehtml::css& stylesheet) override;
+		void				add_ancestor_keys(ancestor_filter& filter) const override;
 		void				refresh_styles() override;
 
 		bool				is_white_space() const override;
@@ -169,7 +182,9 @@ namespace litehtml
 		void				draw(uint_ptr hdc, int x, int y, const position* clip) override;
 		void				draw_background(uint_ptr hdc, int x, int y, const position* clip) override;
 
+		const tchar_t*		get_style_property(css_property id, bool inherited, const tchar_t* def = nullptr) const override;
 		const tchar_t*		get_style_property(const tchar_t* name, bool inherited, const tchar_t* def = nullptr) const override;
+		const computed_style::ptr&	get_computed_style() const override;
 		uint_ptr			get_font(font_metrics* fm = nullptr) override;
 		int					get_font_size() const override;
 
@@ -215,6 +230,9 @@ namespace litehtml
 		void				draw_stacking_context(uint_ptr hdc, int x, int y, const position* clip, bool with_positioned) override;
 		void				calc_document_size(litehtml::size& sz, int x = 0, int y = 0) override;
 		void				get_redraw_box(litehtml::position& pos, int x = 0, int y = 0) override;
+		position			build_spatial_index() override;
+		bool				has_child_at_point(int x, int y) const override;
+		bool				is_overlapped(const position& region, const element* target, const std::vector<const element*>& ancestors) const override;
 		void				add_style(const tstring& style, const tstring& baseurl) override;
 		element::ptr		get_element_by_point(int x, int y, int client_x, int client_y) override;
 		element::ptr		get_child_by_point(int x, int y, int client_x, int client_y, draw_flag flag, int zindex) override;
@@ -227,10 +245,16 @@ namespace litehtml
 	protected:
 		void				draw_children_box(uint_ptr hdc, int x, int y, const position* clip, draw_flag flag, int zindex);
 		void				draw_children_table(uint_ptr hdc, int x, int y, const position* clip, draw_flag flag, int zindex);
+		void				build_text_runs();
+		void				draw_text_run(uint_ptr hdc, int x, int y, const position* clip, const text_run& run);
 		int					render_box(int x, int y, int max_width, bool second_pass = false);
 		int					render_table(int x, int y, int max_width, bool second_pass = false);
 		int					fix_line_width(int max_width, element_float flt);
 		void				parse_background();
+		void				compute_style();
+		void				parse_style_fields();
+		void				copy_style_fields(const html_tag& src);
+		bool				can_share_style(const html_tag& sibling) const;
 		void				init_background_paint( position pos, background_paint &bg_paint, const background* bg );
 		void				draw_list_marker( uint_ptr hdc, const position &pos );
 		tstring				get_list_marker_text(int index);
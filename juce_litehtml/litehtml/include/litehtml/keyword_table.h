@@ -0,0 +1,242 @@
+#ifndef LH_KEYWORD_TABLE_H
+#define LH_KEYWORD_TABLE_H
+
+#include "os_types.h"
+#include "tstring_view.h"
+
+namespace litehtml
+{
+	// Number of the keywords in the ';' separated list
+	constexpr size_t keyword_count(const tchar_t* list)
+	{
+		size_t count = 1;
+		for(; *list; list++)
+		{
+			if(*list == _t(';'))
+			{
+				count++;
+			}
+		}
+		return count;
+	}
+
+	// Fails the constant evaluation of a table that could not be built
+	inline void keyword_table_overflow() {}
+
+	// Keyword list looked up with a perfect hash built at compile time.
+	//
+	// The keywords are spread into the buckets by their hash, then each bucket
+	// gets a seed that moves its keywords into distinct slots (hash and displace).
+	// A lookup hashes the value once, reads the seed of the bucket and compares
+	// the value with the only keyword that can match it. Nothing gets allocated.
+	//
+	// The keywords get the index of their position in the list, like value_index().
+	template<size_t N>
+	class keyword_table
+	{
+		enum
+		{
+			buckets_count	= N <= 1 ? 1 : (N <= 2 ? 2 : (N <= 4 ? 4 : (N <= 8 ? 8 : (N <= 16 ? 16 : (N <= 32 ? 32 : (N <= 64 ? 64 : (N <= 128 ? 128 : 256))))))),
+			slots_count		= buckets_count * 2,
+		};
+		static_assert(N <= 256, "keyword_table supports up to 256 keywords");
+
+		struct slot
+		{
+			const tchar_t*	str		= nullptr;
+			unsigned short	length	= 0;
+			short			index	= -1;
+		};
+
+		slot			m_slots[slots_count]	= {};
+		unsigned short	m_seeds[buckets_count]	= {};
+		bool			m_ignore_case			= false;
+
+	public:
+		// Keywords of the ';' separated list
+		constexpr keyword_table(const tchar_t* list, bool ignore_case = false) : m_ignore_case(ignore_case)
+		{
+			const tchar_t* keys[N] = {};
+			size_t lengths[N] = {};
+
+			size_t count = 0;
+			const tchar_t* start = list;
+			for(const tchar_t* ch = list; ; ch++)
+			{
+				if(!*ch || *ch == _t(';'))
+				{
+					keys[count] = start;
+					lengths[count] = (size_t) (ch - start);
+					count++;
+					if(!*ch) break;
+					start = ch + 1;
+				}
+			}
+			build(keys, lengths);
+		}
+
+		// Keywords taken from a member of the items
+		template<class T>
+		constexpr keyword_table(const T* items, const tchar_t* const T::* key, bool ignore_case = false) : m_ignore_case(ignore_case)
+		{
+			const tchar_t* keys[N] = {};
+			size_t lengths[N] = {};
+
+			for(size_t i = 0; i < N; i++)
+			{
+				keys[i] = items[i].*key;
+				while(keys[i][lengths[i]])
+				{
+					lengths[i]++;
+				}
+			}
+			build(keys, lengths);
+		}
+
+		int find(const tchar_t* str, size_t len, int def = -1) const
+		{
+			unsigned int h = hash(str, len);
+			const slot& s = m_slots[mix(h, m_seeds[mix(h, 0) & (buckets_count - 1)]) & (slots_count - 1)];
+			if(s.index >= 0 && s.length == len && equal(s.str, str, len))
+			{
+				return s.index;
+			}
+			return def;
+		}
+
+		int find(const tstring_view& str, int def = -1) const
+		{
+			return find(str.data(), str.size(), def);
+		}
+
+		int find(const tstring& str, int def = -1) const
+		{
+			return find(str.c_str(), str.length(), def);
+		}
+
+		int find(const tchar_t* str, int def = -1) const
+		{
+			if(!str)
+			{
+				return def;
+			}
+			return find(str, t_strlen(str), def);
+		}
+
+	private:
+		static constexpr tchar_t to_lower(tchar_t ch)
+		{
+			return (ch >= _t('A') && ch <= _t('Z')) ? (tchar_t) (ch - _t('A') + _t('a')) : ch;
+		}
+
+		// The hash ignores the case, the tables that match the case compare the keywords exactly
+		static constexpr unsigned int hash(const tchar_t* str, size_t len)
+		{
+			unsigned int h = 2166136261u;
+			for(size_t i = 0; i < len; i++)
+			{
+				h = (h ^ (unsigned int) to_lower(str[i])) * 16777619u;
+			}
+			return h;
+		}
+
+		static constexpr unsigned int mix(unsigned int h, unsigned int seed)
+		{
+			h ^= seed * 0x9E3779B9u;
+			h ^= h >> 16;
+			h *= 0x85EBCA6Bu;
+			h ^= h >> 13;
+			return h;
+		}
+
+		bool equal(const tchar_t* keyword, const tchar_t* str, size_t len) const
+		{
+			for(size_t i = 0; i < len; i++)
+			{
+				if(keyword[i] != str[i] && (!m_ignore_case || to_lower(keyword[i]) != to_lower(str[i])))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		constexpr void build(const tchar_t* const* keys, const size_t* lengths)
+		{
+			unsigned int hashes[N] = {};
+			size_t bucket_sizes[buckets_count] = {};
+			size_t bucket_starts[buckets_count] = {};
+			size_t max_size = 0;
+
+			for(size_t i = 0; i < N; i++)
+			{
+				hashes[i] = hash(keys[i], lengths[i]);
+				size_t b = mix(hashes[i], 0) & (buckets_count - 1);
+				if(++bucket_sizes[b] > max_size)
+				{
+					max_size = bucket_sizes[b];
+				}
+			}
+
+			// keywords ordered by bucket
+			size_t order[N] = {};
+			size_t next[buckets_count] = {};
+			for(size_t b = 1; b < buckets_count; b++)
+			{
+				bucket_starts[b] = next[b] = bucket_starts[b - 1] + bucket_sizes[b - 1];
+			}
+			for(size_t i = 0; i < N; i++)
+			{
+				order[next[mix(hashes[i], 0) & (buckets_count - 1)]++] = i;
+			}
+
+			// the largest buckets are placed first, while most of the slots are free
+			size_t slots[N] = {};
+			for(size_t size = max_size; size > 0; size--)
+			{
+				for(size_t b = 0; b < buckets_count; b++)
+				{
+					if(bucket_sizes[b] != size) continue;
+
+					const size_t* members = order + bucket_starts[b];
+					unsigned int seed = 1;
+					for(; seed <= 0xFFFF; seed++)
+					{
+						bool fits = true;
+						for(size_t i = 0; i < size && fits; i++)
+						{
+							slots[i] = mix(hashes[members[i]], seed) & (slots_count - 1);
+							if(m_slots[slots[i]].index >= 0)
+							{
+								fits = false;
+							}
+							for(size_t j = 0; j < i && fits; j++)
+							{
+								if(slots[j] == slots[i])
+								{
+									fits = false;
+								}
+							}
+						}
+						if(fits) break;
+					}
+					if(seed > 0xFFFF)
+					{
+						keyword_table_overflow();
+					}
+
+					m_seeds[b] = (unsigned short) seed;
+					for(size_t i = 0; i < size; i++)
+					{
+						slot& s = m_slots[slots[i]];
+						s.str		= keys[members[i]];
+						s.length	= (unsigned short) lengths[members[i]];
+						s.index		= (short) members[i];
+					}
+				}
+			}
+		}
+	};
+}
+
+#endif  // LH_KEYWORD_TABLE_H
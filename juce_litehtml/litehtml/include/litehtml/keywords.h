@@ -0,0 +1,39 @@
+#ifndef LH_KEYWORDS_H
+#define LH_KEYWORDS_H
+
+#include "types.h"
+#include "keyword_table.h"
+
+namespace litehtml
+{
+	// Lookup tables of the keyword lists from types.h, built at compile time
+	extern const keyword_table<keyword_count(style_display_strings)>	style_display_keywords;
+	extern const keyword_table<keyword_count(font_style_strings)>	font_style_keywords;
+	extern const keyword_table<keyword_count(font_variant_strings)>	font_variant_keywords;
+	extern const keyword_table<keyword_count(font_weight_strings)>	font_weight_keywords;
+	extern const keyword_table<keyword_count(list_style_type_strings)>	list_style_type_keywords;
+	extern const keyword_table<keyword_count(list_style_position_strings)>	list_style_position_keywords;
+	extern const keyword_table<keyword_count(vertical_align_strings)>	vertical_align_keywords;
+	extern const keyword_table<keyword_count(border_width_strings)>	border_width_keywords;
+	extern const keyword_table<keyword_count(border_style_strings)>	border_style_keywords;
+	extern const keyword_table<keyword_count(element_float_strings)>	element_float_keywords;
+	extern const keyword_table<keyword_count(element_clear_strings)>	element_clear_keywords;
+	extern const keyword_table<keyword_count(css_units_strings)>	css_units_keywords;
+	extern const keyword_table<keyword_count(background_attachment_strings)>	background_attachment_keywords;
+	extern const keyword_table<keyword_count(background_repeat_strings)>	background_repeat_keywords;
+	extern const keyword_table<keyword_count(background_box_strings)>	background_box_keywords;
+	extern const keyword_table<keyword_count(element_position_strings)>	element_position_keywords;
+	extern const keyword_table<keyword_count(text_align_strings)>	text_align_keywords;
+	extern const keyword_table<keyword_count(text_transform_strings)>	text_transform_keywords;
+	extern const keyword_table<keyword_count(white_space_strings)>	white_space_keywords;
+	extern const keyword_table<keyword_count(overflow_strings)>	overflow_keywords;
+	extern const keyword_table<keyword_count(visibility_strings)>	visibility_keywords;
+	extern const keyword_table<keyword_count(border_collapse_strings)>	border_collapse_keywords;
+	extern const keyword_table<keyword_count(box_sizing_strings)>	box_sizing_keywords;
+	extern const keyword_table<keyword_count(pseudo_class_strings)>	pseudo_class_keywords;
+	extern const keyword_table<keyword_count(media_orientation_strings)>	media_orientation_keywords;
+	extern const keyword_table<keyword_count(media_feature_strings)>	media_feature_keywords;
+	extern const keyword_table<keyword_count(media_type_strings)>	media_type_keywords;
+}
+
+#endif  // LH_KEYWORDS_H
@@ -0,0 +1,38 @@
+#ifndef LH_SPATIAL_INDEX_H
+#define LH_SPATIAL_INDEX_H
+
+namespace litehtml
+{
+	// Half-extent of the ink box of the elements painted relative to the
+	// viewport (position: fixed), so they intersect any clip rectangle.
+	const int ink_unbounded = 0x20000000;
+
+	// Post-layout index of the element children ink boxes (the area painted
+	// by the child together with its descendants).
+	//
+	// Children are kept in the document order, which is the painting order.
+	// The prefix maximum of the bottom edges and the suffix minimum of the top
+	// edges are both monotonic, so the range of the children that may intersect
+	// a horizontal band is found with two binary searches.
+	class spatial_index
+	{
+		position::vector	m_ink;
+		std::vector<int>	m_max_bottom;
+		std::vector<int>	m_min_top;
+	public:
+		void				clear();
+		void				add(const position& ink);
+		void				finish();
+
+		size_t				size() const				{ return m_ink.size();	}
+		const position&		ink(size_t idx) const		{ return m_ink[idx];	}
+
+		// Returns the range [first, last) of the children which may intersect [top, bottom]
+		void				find(int top, int bottom, size_t& first, size_t& last) const;
+
+		static position		unbounded();
+		static void			unite(position& dst, const position& src);
+	};
+}
+
+#endif  // LH_SPATIAL_INDEX_H
@@ -3,9 +3,106 @@
 
 #include "attributes.h"
 #include <string>
+#include <bitset>
 
 namespace litehtml
 {
+#define  css_property_strings		_t("color;font-family;font-style;font-variant;font-weight;line-height;text-align;text-decoration;text-indent;text-transform;white-space;vertical-align;visibility;cursor;list-style-type;list-style-position;list-style-image;list-style-image-baseurl;border-collapse;-litehtml-border-spacing-x;-litehtml-border-spacing-y;font-size;content;display;position;float;clear;overflow;box-sizing;z-index;left;right;top;bottom;width;height;min-width;min-height;max-width;max-height;margin-left;margin-right;margin-top;margin-bottom;padding-left;padding-right;padding-top;padding-bottom;border-left-width;border-right-width;border-top-width;border-bottom-width;border-left-style;border-right-style;border-top-style;border-bottom-style;border-left-color;border-right-color;border-top-color;border-bottom-color;border-top-left-radius-x;border-top-left-radius-y;border-top-right-radius-x;border-top-right-radius-y;border-bottom-right-radius-x;border-bottom-right-radius-y;border-bottom-left-radius-x;border-bottom-left-radius-y;background-color;background-image;background-image-baseurl;background-repeat;background-origin;background-clip;background-attachment;background-position;background-size")
+
+	// Longhand properties known to the layout.
+	// Custom properties and the properties not listed here are kept by name.
+	enum css_property
+	{
+		css_property_unknown = -1,
+
+		// looked up through the parents when not declared
+		css_property_color,
+		css_property_font_family,
+		css_property_font_style,
+		css_property_font_variant,
+		css_property_font_weight,
+		css_property_line_height,
+		css_property_text_align,
+		css_property_text_decoration,
+		css_property_text_indent,
+		css_property_text_transform,
+		css_property_white_space,
+		css_property_vertical_align,
+		css_property_visibility,
+		css_property_cursor,
+		css_property_list_style_type,
+		css_property_list_style_position,
+		css_property_list_style_image,
+		css_property_list_style_image_baseurl,
+		css_property_border_collapse,
+		css_property_litehtml_border_spacing_x,
+		css_property_litehtml_border_spacing_y,
+
+		css_property_font_size,
+		css_property_content,
+		css_property_display,
+		css_property_position,
+		css_property_float,
+		css_property_clear,
+		css_property_overflow,
+		css_property_box_sizing,
+		css_property_z_index,
+		css_property_left,
+		css_property_right,
+		css_property_top,
+		css_property_bottom,
+		css_property_width,
+		css_property_height,
+		css_property_min_width,
+		css_property_min_height,
+		css_property_max_width,
+		css_property_max_height,
+		css_property_margin_left,
+		css_property_margin_right,
+		css_property_margin_top,
+		css_property_margin_bottom,
+		css_property_padding_left,
+		css_property_padding_right,
+		css_property_padding_top,
+		css_property_padding_bottom,
+		css_property_border_left_width,
+		css_property_border_right_width,
+		css_property_border_top_width,
+		css_property_border_bottom_width,
+		css_property_border_left_style,
+		css_property_border_right_style,
+		css_property_border_top_style,
+		css_property_border_bottom_style,
+		css_property_border_left_color,
+		css_property_border_right_color,
+		css_property_border_top_color,
+		css_property_border_bottom_color,
+		css_property_border_top_left_radius_x,
+		css_property_border_top_left_radius_y,
+		css_property_border_top_right_radius_x,
+		css_property_border_top_right_radius_y,
+		css_property_border_bottom_right_radius_x,
+		css_property_border_bottom_right_radius_y,
+		css_property_border_bottom_left_radius_x,
+		css_property_border_bottom_left_radius_y,
+		css_property_background_color,
+		css_property_background_image,
+		css_property_background_image_baseurl,
+		css_property_background_repeat,
+		css_property_background_origin,
+		css_property_background_clip,
+		css_property_background_attachment,
+		css_property_background_position,
+		css_property_background_size,
+
+		css_property_count
+	};
+
+	// The inherited properties come first
+	const int css_inherited_count = css_property_litehtml_border_spacing_y + 1;
+
+	css_property css_property_id(const tchar_t* name);
+
 	class property_value
 	{
 	public:
@@ -21,21 +118,60 @@ namespace litehtml
 			m_important = imp;
 			m_value		= val;
 		}
-		property_value(const property_value& val)
+	};
+
+	typedef std::map<tstring, property_value>	props_map;
+
+	// Values of the inherited and the custom properties after the cascade.
+	// They are resolved once per element from the parent's values, the elements
+	// that declare none of these properties share the object of their parent.
+	class computed_style
+	{
+	public:
+		typedef std::shared_ptr<const computed_style>	ptr;
+
+		std::bitset<css_inherited_count>	m_set;			// properties present in m_values
+		string_vector						m_values;		// packed in the css_property order
+		string_map							m_custom;
+
+		const tchar_t* get_property(css_property id) const
+		{
+			if(m_set.test(id))
+			{
+				return m_values[value_pos(id)].c_str();
+			}
+			return nullptr;
+		}
+
+		void set_property(css_property id, const tstring& val)
 		{
-			m_value		= val.m_value;
-			m_important	= val.m_important;
+			size_t pos = value_pos(id);
+			if(m_set.test(id))
+			{
+				m_values[pos] = val;
+			} else
+			{
+				m_values.insert(m_values.begin() + pos, val);
+				m_set.set(id);
+			}
 		}
 
-		property_value& operator=(const property_value& val)
+		const tchar_t* get_custom_property(const tchar_t* name) const
 		{
-			m_value		= val.m_value;
-			m_important	= val.m_important;
-			return *this;
+			auto f = m_custom.find(name);
+			if(f != m_custom.end())
+			{
+				return f->second.c_str();
+			}
+			return nullptr;
 		}
-	};
 
-	typedef std::map<tstring, property_value>	props_map;
+	private:
+		size_t value_pos(css_property id) const
+		{
+			return (m_set << (css_inherited_count - id)).count();
+		}
+	};
 
 	class style
 	{
@@ -43,17 +179,11 @@ namespace litehtml
 		typedef std::shared_ptr<style>		ptr;
 		typedef std::vector<style::ptr>		vector;
 	private:
-		props_map			m_properties;
-		static string_map	m_valid_values;
+		std::bitset<css_property_count>	m_set;			// known properties present in m_values
+		std::vector<property_value>		m_values;		// values of the known properties, in the css_property order
+		props_map						m_custom;		// custom and unknown properties
 	public:
 		style() = default;
-		style(const style& val);
-
-		style& operator=(const style& val)
-		{
-			m_properties = val.m_properties;
-            return *this;
-		}
 
 		void add(const tchar_t* txt, const tchar_t* baseurl, const element* el)
 		{
@@ -62,26 +192,33 @@ namespace litehtml
 
 		void add_property(const tchar_t* name, const tchar_t* val, const tchar_t* baseurl, bool important, const element* el);
 
-		const tchar_t* get_property(const tchar_t* name) const
+		const tchar_t* get_property(css_property id) const
 		{
-			if(name)
+			if(id != css_property_unknown && m_set.test(id))
 			{
-				auto f = m_properties.find(name);
-				if(f != m_properties.end())
-				{
-					return f->second.m_value.c_str();
-				}
+				return m_values[value_pos(id)].m_value.c_str();
 			}
 			return nullptr;
 		}
 
+		const tchar_t* get_property(const tchar_t* name) const;
+
 		void combine(const litehtml::style& src);
+		computed_style::ptr compute(const computed_style::ptr& parent) const;
 		void clear()
 		{
-			m_properties.clear();
+			m_set.reset();
+			m_values.clear();
+			m_custom.clear();
 		}
 
 	private:
+		// Position of the property value in m_values
+		size_t value_pos(css_property id) const
+		{
+			return (m_set << (css_property_count - id)).count();
+		}
+
 		void parse_property(const tstring& txt, const tchar_t* baseurl, const element* el);
 		void parse(const tchar_t* txt, const tchar_t* baseurl, const element* el);
 		void parse_short_border(const tstring& prefix, const tstring& val, bool important);
@@ -89,6 +226,7 @@ namespace litehtml
 		void parse_short_font(const tstring& val, bool important);
 		static void subst_vars(tstring& str, const element* el);
 		void add_parsed_property(const tstring& name, const tstring& val, bool important);
+		void add_parsed_property(css_property id, const tstring& val, bool important);
 		void remove_property(const tstring& name, bool important);
 	};
 }
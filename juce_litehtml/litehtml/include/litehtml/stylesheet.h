@@ -1,6 +1,7 @@
 #ifndef LH_STYLESHEET_H
 #define LH_STYLESHEET_H
 
+#include <unordered_map>
 #include "style.h"
 #include "css_selector.h"
 
@@ -10,7 +11,17 @@ namespace litehtml
 
 	class css
 	{
+		typedef std::unordered_map<atom, int_vector>	rules_map;
+
 		css_selector::vector	m_selectors;
+		// Indexes of the selectors grouped by the id, a class or the tag of
+		// their rightmost compound selector, in the order of m_selectors.
+		// A selector is stored in the first group that applies.
+		rules_map				m_id_rules;
+		rules_map				m_class_rules;
+		rules_map				m_tag_rules;
+		int_vector				m_universal_rules;
+		std::shared_ptr<const atom_table>	m_atoms;	// the table the names were interned into, when owned by the stylesheet
 	public:
 		css() = default;
 		~css() = default;
@@ -20,19 +31,37 @@ namespace litehtml
 			return m_selectors;
 		}
 
+		const std::shared_ptr<const atom_table>& atoms() const
+		{
+			return m_atoms;
+		}
+
+		void set_atoms(const std::shared_ptr<const atom_table>& atoms)
+		{
+			m_atoms = atoms;
+		}
+
 		void clear()
 		{
 			m_selectors.clear();
+			m_id_rules.clear();
+			m_class_rules.clear();
+			m_tag_rules.clear();
+			m_universal_rules.clear();
 		}
 
-		void	parse_stylesheet(const tchar_t* str, const tchar_t* baseurl, const std::shared_ptr <document>& doc, const media_query_list::ptr& media);
+		// The names used by the selectors are interned into atoms
+		void	parse_stylesheet(const tchar_t* str, const tchar_t* baseurl, const std::shared_ptr <document>& doc, const media_query_list::ptr& media, atom_table& atoms);
 		void	sort_selectors();
+		// Indexes of the selectors that can match an element, in the cascade order
+		void	get_candidates(atom id, const std::vector<atom>& classes, atom tag, int_vector& res) const;
 		static void	parse_css_url(const tstring& str, tstring& url);
 
 	private:
-		void	parse_atrule(const tstring& text, const tchar_t* baseurl, const std::shared_ptr<document>& doc, const media_query_list::ptr& media);
+		void	parse_atrule(const tstring& text, const tchar_t* baseurl, const std::shared_ptr<document>& doc, const media_query_list::ptr& media, atom_table& atoms);
 		void	add_selector(const css_selector::ptr& selector);
-		bool	parse_selectors(const tstring& txt, const tstring& styles, const media_query_list::ptr& media, const tstring& baseurl);
+		void	add_rule(int idx);
+		bool	parse_selectors(const tstring& txt, const tstring& styles, const media_query_list::ptr& media, const tstring& baseurl, atom_table& atoms);
 
 	};
 
@@ -40,6 +69,7 @@ namespace litehtml
 	{
 		selector->m_order = (int) m_selectors.size();
 		m_selectors.push_back(selector);
+		add_rule(selector->m_order);
 	}
 
 }
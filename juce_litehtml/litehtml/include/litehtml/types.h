@@ -743,6 +743,25 @@ namespace litehtml
 		render_fixed_only,
 	};
 
+	struct text_run_part
+	{
+		tstring			text;
+		int				x;		// offset from the run left
+		int				width;
+	};
+
+	// adjacent words of one line sharing the font and color
+	struct text_run
+	{
+		size_t						id;		// unique, stays the same until the next layout
+		size_t						first;	// index of the first child element or word
+		size_t						last;	// index of the last child element or word
+		position					pos;
+		std::vector<text_run_part>	parts;
+
+		static size_t				new_id();
+	};
+
 	// List of the Void Elements (can't have any contents)
 	const litehtml::tchar_t* const void_elements = _t("area;base;br;col;command;embed;hr;img;input;keygen;link;meta;param;source;track;wbr");
 }
@@ -9,7 +9,7 @@ namespace litehtml
 		const tchar_t*	rgb;
 	};
 
-	extern def_color g_def_colors[];
+	extern const def_color g_def_colors[];
 
     class document_container;
 
@@ -0,0 +1,42 @@
+#include "html.h"
+#include "ancestor_filter.h"
+
+void litehtml::ancestor_filter::push(const element* el)
+{
+	m_entries.push_back({el, m_keys.size()});
+}
+
+void litehtml::ancestor_filter::add(unsigned int key)
+{
+	m_keys.push_back(key);
+
+	// saturated counters stay set, they can't be decremented safely
+	unsigned char& c1 = m_counters[key & key_mask];
+	unsigned char& c2 = m_counters[(key >> key_bits) & key_mask];
+	if(c1 != 0xFF) c1++;
+	if(c2 != 0xFF) c2++;
+}
+
+void litehtml::ancestor_filter::pop()
+{
+	if(m_entries.empty())
+	{
+		return;
+	}
+	for(size_t i = m_entries.back().first_key; i < m_keys.size(); i++)
+	{
+		unsigned char& c1 = m_counters[m_keys[i] & key_mask];
+		unsigned char& c2 = m_counters[(m_keys[i] >> key_bits) & key_mask];
+		if(c1 != 0xFF) c1--;
+		if(c2 != 0xFF) c2--;
+	}
+	m_keys.resize(m_entries.back().first_key);
+	m_entries.pop_back();
+}
+
+void litehtml::ancestor_filter::clear()
+{
+	std::fill(std::begin(m_counters), std::end(m_counters), 0);
+	m_keys.clear();
+	m_entries.clear();
+}
@@ -0,0 +1,89 @@
+#include "html.h"
+#include "arena.h"
+
+litehtml::arena::arena(size_t block_size)
+{
+	m_block_size		= block_size;
+	m_cur				= nullptr;
+	m_end				= nullptr;
+	m_bytes_allocated	= 0;
+	m_bytes_reserved	= 0;
+}
+
+litehtml::arena::~arena()
+{
+	for(auto block : m_blocks)
+	{
+		delete[] block;
+	}
+}
+
+void* litehtml::arena::allocate(size_t size, size_t align)
+{
+	if(align <= granule)
+	{
+		size = chunk_size(size);
+		align = granule;
+
+		size_t idx = size / granule;
+		if(idx < m_free.size() && m_free[idx])
+		{
+			void* ret = m_free[idx];
+			m_free[idx] = *static_cast<void**>(ret);
+			m_bytes_allocated += size;
+			return ret;
+		}
+	}
+
+	size_t pad = (align - reinterpret_cast<uint_ptr>(m_cur) % align) % align;
+
+	if(!m_cur || pad + size > static_cast<size_t>(m_end - m_cur))
+	{
+		if(size + align > m_block_size / 4)
+		{
+			// large allocations get their own block, the current one stays in use
+			char* block = add_block(size + align);
+			pad = (align - reinterpret_cast<uint_ptr>(block) % align) % align;
+			m_bytes_allocated += size;
+			return block + pad;
+		}
+
+		m_cur = add_block(m_block_size);
+		m_end = m_cur + m_block_size;
+		pad = (align - reinterpret_cast<uint_ptr>(m_cur) % align) % align;
+	}
+
+	char* ret = m_cur + pad;
+	m_cur = ret + size;
+	m_bytes_allocated += size;
+	return ret;
+}
+
+void litehtml::arena::deallocate(void* p, size_t size, size_t align)
+{
+	// over-aligned chunks are not reused, they stay until the arena is destroyed
+	if(!p || align > granule)
+	{
+		return;
+	}
+
+	size = chunk_size(size);
+	size_t idx = size / granule;
+	if(idx >= m_free.size())
+	{
+		m_free.resize(idx + 1, nullptr);
+	}
+
+	// the free list link is kept in the chunk itself
+	*static_cast<void**>(p) = m_free[idx];
+	m_free[idx] = p;
+	m_bytes_allocated -= size;
+}
+
+char* litehtml::arena::add_block(size_t size)
+{
+	char* block = new char[size];
+	m_blocks.push_back(block);
+	m_bytes_reserved += size;
+	return block;
+}
@@ -0,0 +1,106 @@
+#include "html.h"
+#include "atoms.h"
+
+litehtml::atom_table::atom_table() : m_parent(&predefined())
+{
+}
+
+litehtml::atom_table::atom_table(const atom_table* parent, const tchar_t* names) : m_parent(parent)
+{
+	string_vector tokens;
+	split_string(names, tokens, _t(";"));
+	for(const auto& token : tokens)
+	{
+		intern(token);
+	}
+}
+
+void litehtml::atom_table::set_parent(const atom_table* parent)
+{
+	m_parent = parent ? parent : &predefined();
+}
+
+litehtml::atom litehtml::atom_table::intern(const tstring& str)
+{
+	if(str.empty())
+	{
+		return nullptr;
+	}
+	return intern(key(str.c_str(), str.length()));
+}
+
+litehtml::atom litehtml::atom_table::intern(const tchar_t* str)
+{
+	if(!str || !str[0])
+	{
+		return nullptr;
+	}
+	return intern(key(str, t_strlen(str)));
+}
+
+litehtml::atom litehtml::atom_table::find(const tstring& str) const
+{
+	if(str.empty())
+	{
+		return nullptr;
+	}
+	return find(key(str.c_str(), str.length()));
+}
+
+litehtml::atom litehtml::atom_table::find(const tchar_t* str) const
+{
+	if(!str || !str[0])
+	{
+		return nullptr;
+	}
+	return find(key(str, t_strlen(str)));
+}
+
+litehtml::atom litehtml::atom_table::intern(const key& k)
+{
+	atom a = find(k);
+	if(a)
+	{
+		return a;
+	}
+	m_strings.emplace_back(k.str, k.len);
+	a = &m_strings.back();
+	m_names.emplace(key(a->c_str(), a->length()), a);
+	return a;
+}
+
+litehtml::atom litehtml::atom_table::find(const key& k) const
+{
+	// the names of the parents win, they are shared with the other tables
+	if(m_parent)
+	{
+		atom a = m_parent->find(k);
+		if(a)
+		{
+			return a;
+		}
+	}
+	auto it = m_names.find(k);
+	return it != m_names.end() ? it->second : nullptr;
+}
+
+litehtml::atom_table::key::key(const tchar_t* s, size_t l) : str(s), len(l)
+{
+	// FNV-1a
+	hash = 2166136261u;
+	for(size_t i = 0; i < len; i++)
+	{
+		hash = (hash ^ (size_t) str[i]) * 16777619u;
+	}
+}
+
+bool litehtml::atom_table::key::operator==(const key& val) const
+{
+	return len == val.len && !tstring::traits_type::compare(str, val.str, len);
+}
+
+const litehtml::atom_table& litehtml::atom_table::predefined()
+{
+	static const atom_table table(nullptr, _t("id;class;pseudo;pseudo-el;::before;::after"));
+	return table;
+}
@@ -3,6 +3,7 @@
 
 litehtml::background::background()
 {
+	m_image_handle	= 0;
 	m_attachment	= background_attachment_scroll;
 	m_repeat		= background_repeat_repeat;
 	m_clip			= background_box_border;
@@ -17,6 +18,7 @@ litehtml::background::background( const background& val )
 {
 	m_image			= val.m_image;
 	m_baseurl		= val.m_baseurl;
+	m_image_handle	= val.m_image_handle;
 	m_color			= val.m_color;
 	m_attachment	= val.m_attachment;
 	m_position		= val.m_position;
@@ -29,6 +31,7 @@ litehtml::background& litehtml::background::operator=( const background& val )
 {
 	m_image			= val.m_image;
 	m_baseurl		= val.m_baseurl;
+	m_image_handle	= val.m_image_handle;
 	m_color			= val.m_color;
 	m_attachment	= val.m_attachment;
 	m_position		= val.m_position;
@@ -41,6 +44,7 @@ litehtml::background& litehtml::background::operator=( const background& val )
 
 litehtml::background_paint::background_paint() : color(0, 0, 0, 0)
 {
+	image_handle	= 0;
 	position_x		= 0;
 	position_y		= 0;
 	attachment		= background_attachment_scroll;
@@ -52,6 +56,7 @@ litehtml::background_paint::background_paint( const background_paint& val )
 {
 	image			= val.image;
 	baseurl			= val.baseurl;
+	image_handle	= val.image_handle;
 	attachment		= val.attachment;
 	repeat			= val.repeat;
 	color			= val.color;
@@ -70,6 +75,7 @@ litehtml::background_paint& litehtml::background_paint::operator=( const backgro
 	attachment	= val.m_attachment;
 	baseurl		= val.m_baseurl;
 	image		= val.m_image;
+	image_handle	= val.m_image_handle;
 	repeat		= val.m_repeat;
 	color		= val.m_color;
     return *this;
@@ -291,6 +291,27 @@ void litehtml::line_box::finish(bool last_box)
 	}
 	m_height = y2 - y1;
 	m_baseline = (base_line - y1) - (m_height - line_height);
+
+	merge_fragments();
+}
+
+void litehtml::line_box::merge_fragments()
+{
+	// the adjacent words of a text run are kept as a single item
+	size_t count = 0;
+	for(size_t i = 0; i < m_items.size(); i++)
+	{
+		if(count && !m_items[i]->m_skip && !m_items[count - 1]->m_skip && m_items[count - 1]->merge_fragment(m_items[i]))
+		{
+			continue;
+		}
+		if(count != i)
+		{
+			m_items[count] = std::move(m_items[i]);
+		}
+		count++;
+	}
+	m_items.resize(count);
 }
 
 bool litehtml::line_box::can_hold(const element::ptr &el, white_space ws) const
@@ -9,6 +9,9 @@ extern "C" {
 
 litehtml::context::context()
 {
+	m_use_arena = false;
+	m_master_css = std::make_shared<litehtml::css>();
+
 	m_jsRuntime = JS_NewRuntime();
 	m_jsContext = JS_NewContext(m_jsRuntime);
 
@@ -45,10 +48,28 @@ JSValue litehtml::context::js_eval(const litehtml::tstring& script)
 
 void litehtml::context::load_master_stylesheet( const tchar_t* str )
 {
-	media_query_list::ptr media;
+	// the current stylesheet may be shared, the rules are added to a copy
+	std::shared_ptr<litehtml::css> css = std::make_shared<litehtml::css>(*m_master_css);
+	css->parse_stylesheet(str, nullptr, std::shared_ptr<litehtml::document>(), media_query_list::ptr(), m_atoms);
+	css->sort_selectors();
+	m_master_css = css;
+}
+
+void litehtml::context::set_master_stylesheet( const std::shared_ptr<const litehtml::css>& css )
+{
+	m_master_css = css;
+	m_atoms.set_parent(css->atoms().get());
+}
 
-	m_master_css.parse_stylesheet(str, nullptr, std::shared_ptr<litehtml::document>(), media_query_list::ptr());
-	m_master_css.sort_selectors();
+std::shared_ptr<const litehtml::css> litehtml::context::parse_master_stylesheet( const tchar_t* str )
+{
+	// the names go to the table of the stylesheet, it is the parent of the tables of the contexts using it
+	std::shared_ptr<atom_table> atoms = std::make_shared<atom_table>();
+	std::shared_ptr<litehtml::css> css = std::make_shared<litehtml::css>();
+	css->parse_stylesheet(str, nullptr, std::shared_ptr<litehtml::document>(), media_query_list::ptr(), *atoms);
+	css->sort_selectors();
+	css->set_atoms(atoms);
+	return css;
 }
 
 void litehtml::context::js_register_method(JSContext* ctx, JSValue prototype, const tchar_t* name, JSCFunction func)
@@ -43,7 +43,7 @@ void litehtml::css_length::fromString( const tstring& str, const tstring& predef
 		if(!num.empty())
 		{
 			m_value = (float) t_strtod(num.c_str(), nullptr);
-			m_units	= (css_units) value_index(un, css_units_strings, css_units_none);
+			m_units	= (css_units) value_index(un, css_units_keywords, css_units_none);
 		} else
 		{
 			// not a number so it is predefined
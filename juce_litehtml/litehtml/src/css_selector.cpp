@@ -2,11 +2,12 @@
 #include "css_selector.h"
 #include "document.h"
 
-void litehtml::css_element_selector::parse( const tstring& txt )
+void litehtml::css_element_selector::parse( const tstring& txt, atom_table& atoms )
 {
 	tstring::size_type el_end = txt.find_first_of(_t(".#[:"));
-	m_tag = txt.substr(0, el_end);
-	litehtml::lcase(m_tag);
+	tstring tag = txt.substr(0, el_end);
+	litehtml::lcase(tag);
+	m_tag = (tag.empty() || tag == _t("*")) ? nullptr : atoms.intern(tag);
 	m_attrs.clear();
 	while(el_end != tstring::npos)
 	{
@@ -16,9 +17,8 @@ void litehtml::css_element_selector::parse( const tstring& txt )
 
 			tstring::size_type pos = txt.find_first_of(_t(".#[:"), el_end + 1);
 			attribute.val		= txt.substr(el_end + 1, pos - el_end - 1);
-			split_string( attribute.val, attribute.class_val, _t(" ") );
 			attribute.condition	= select_equal;
-			attribute.attribute	= _t("class");
+			attribute.attribute	= atom_class();
 			m_attrs.push_back(attribute);
 			el_end = pos;
 		} else if(txt[el_end] == _t(':'))
@@ -31,7 +31,7 @@ void litehtml::css_element_selector::parse( const tstring& txt )
 				attribute.val		= txt.substr(el_end + 2, pos - el_end - 2);
 				attribute.condition	= select_pseudo_element;
 				litehtml::lcase(attribute.val);
-				attribute.attribute	= _t("pseudo-el");
+				attribute.attribute	= atom_table::predefined().find(_t("pseudo-el"));
 				m_attrs.push_back(attribute);
 				el_end = pos;
 			} else
@@ -60,7 +60,7 @@ void litehtml::css_element_selector::parse( const tstring& txt )
 				{
 					attribute.condition	= select_pseudo_class;
 				}
-				attribute.attribute	= _t("pseudo");
+				attribute.attribute	= atom_table::predefined().find(_t("pseudo"));
 				m_attrs.push_back(attribute);
 				el_end = pos;
 			}
@@ -71,7 +71,7 @@ void litehtml::css_element_selector::parse( const tstring& txt )
 			tstring::size_type pos = txt.find_first_of(_t(".#[:"), el_end + 1);
 			attribute.val		= txt.substr(el_end + 1, pos - el_end - 1);
 			attribute.condition	= select_equal;
-			attribute.attribute	= _t("id");
+			attribute.attribute	= atom_id();
 			m_attrs.push_back(attribute);
 			el_end = pos;
 		} else if(txt[el_end] == _t('['))
@@ -139,7 +139,7 @@ void litehtml::css_element_selector::parse( const tstring& txt )
 			{
 				attribute.condition = select_exists;
 			}
-			attribute.attribute	= attr;
+			attribute.attribute	= atoms.intern(attr);
 			m_attrs.push_back(attribute);
 			el_end = pos;
 		} else
@@ -148,10 +148,34 @@ void litehtml::css_element_selector::parse( const tstring& txt )
 		}
 		el_end = txt.find_first_of(_t(".#[:"), el_end);
 	}
+
+	// ids and classes are matched as lower case atoms
+	for(auto& attribute : m_attrs)
+	{
+		if(attribute.condition != select_equal)
+		{
+			continue;
+		}
+		if(attribute.attribute == atom_class())
+		{
+			string_vector tokens;
+			split_string( attribute.val, tokens, _t(" ") );
+			for(auto& token : tokens)
+			{
+				litehtml::lcase(token);
+				attribute.class_val.push_back(atoms.intern(token));
+			}
+		} else if(attribute.attribute == atom_id())
+		{
+			tstring id = attribute.val;
+			litehtml::lcase(id);
+			attribute.val_atom = atoms.intern(id);
+		}
+	}
 }
 
 
-bool litehtml::css_selector::parse( const tstring& text )
+bool litehtml::css_selector::parse( const tstring& text, atom_table& atoms )
 {
 	if(text.empty())
 	{
@@ -192,7 +216,7 @@ bool litehtml::css_selector::parse( const tstring& text )
 		return false;
 	}
 
-	m_right.parse(right);
+	m_right.parse(right, atoms);
 
 	switch(combinator)
 	{
@@ -215,7 +239,7 @@ bool litehtml::css_selector::parse( const tstring& text )
 	if(!left.empty())
 	{
 		m_left = std::make_shared<css_selector>(media_query_list::ptr(nullptr), _t(""));
-		if(!m_left->parse(left))
+		if(!m_left->parse(left, atoms))
 		{
 			return false;
 		}
@@ -226,18 +250,18 @@ bool litehtml::css_selector::parse( const tstring& text )
 
 void litehtml::css_selector::calc_specificity()
 {
-	if(!m_right.m_tag.empty() && m_right.m_tag != _t("*"))
+	if(m_right.m_tag)
 	{
 		m_specificity.d = 1;
 	}
 	for(const auto& attr : m_right.m_attrs)
 	{
-		if(attr.attribute == _t("id"))
+		if(attr.attribute == atom_id())
 		{
 			m_specificity.b++;
 		} else
 		{
-			if(attr.attribute == _t("class"))
+			if(attr.attribute == atom_class())
 			{
 				m_specificity.c += (int) attr.class_val.size();
 			} else
@@ -253,6 +277,74 @@ void litehtml::css_selector::calc_specificity()
 	}
 }
 
+void litehtml::css_selector::calc_ancestor_keys()
+{
+	m_ancestor_keys.clear();
+
+	// only the parts directly left of a descendant or child combinator are ancestors of the element,
+	// in "h1 + div p" the h1 is a sibling of an ancestor and must not be required in the filter
+	for(const css_selector* sel = this; sel->m_left; sel = sel->m_left.get())
+	{
+		if(sel->m_combinator != combinator_descendant && sel->m_combinator != combinator_child)
+		{
+			continue;
+		}
+		const css_element_selector& part = sel->m_left->m_right;
+		if(part.m_tag)
+		{
+			m_ancestor_keys.push_back(ancestor_filter::key(part.m_tag, ancestor_filter::key_tag));
+		}
+		for(const auto& attr : part.m_attrs)
+		{
+			if(attr.condition != select_equal)
+			{
+				continue;
+			}
+			if(attr.attribute == atom_id())
+			{
+				m_ancestor_keys.push_back(ancestor_filter::key(attr.val_atom, ancestor_filter::key_id));
+			} else if(attr.attribute == atom_class())
+			{
+				for(atom cls : attr.class_val)
+				{
+					m_ancestor_keys.push_back(ancestor_filter::key(cls, ancestor_filter::key_class));
+				}
+			}
+		}
+	}
+}
+
+void litehtml::css_selector::calc_sibling_dependence()
+{
+	m_sibling_dependent = false;
+
+	// structural pseudo classes of the element itself, :not() is checked as a whole
+	for(const auto& attr : m_right.m_attrs)
+	{
+		if(attr.condition != select_pseudo_class)
+		{
+			continue;
+		}
+		tstring::size_type begin = attr.val.find_first_of(_t('('));
+		tstring name = attr.val.substr(0, begin);
+		trim(name);
+		int pseudo = value_index(name, pseudo_class_keywords);
+		if(pseudo >= pseudo_class_only_child && pseudo <= pseudo_class_nth_last_of_type)
+		{
+			m_sibling_dependent = true;
+		} else if(pseudo == pseudo_class_not && begin != tstring::npos && attr.val.find_first_of(_t(':'), begin) != tstring::npos)
+		{
+			m_sibling_dependent = true;
+		}
+	}
+
+	// the siblings of an ancestor are shared by all its descendants
+	if(m_left && (m_combinator == combinator_adjacent_sibling || m_combinator == combinator_general_sibling))
+	{
+		m_sibling_dependent = true;
+	}
+}
+
 void litehtml::css_selector::add_media_to_doc( document* doc ) const
 {
 	if(m_media_query && doc)
@@ -5,6 +5,7 @@
 #include "el_text.h"
 #include "el_para.h"
 #include "el_space.h"
+#include "el_text_run.h"
 #include "el_body.h"
 #include "el_image.h"
 #include "el_table.h"
@@ -35,6 +36,14 @@ litehtml::document::document(litehtml::document_container* objContainer, litehtm
 {
 	m_container	= objContainer;
 	m_context	= ctx;
+	m_draw_fixed	= true;
+	m_scrolled_fixed	= false;
+	m_style_siblings	= nullptr;
+
+	if(ctx->use_arena())
+	{
+		m_arena = std::make_shared<arena>();
+	}
 
 	m_jsValue   = JS_NewObjectClass(ctx->js_context(), jsClassID);
 	JS_SetOpaque (m_jsValue, new js_object_ref(this));
@@ -101,12 +110,12 @@ static JSValue js_createTextNode(JSContext* ctx, JSValueConst self, int argc, JS
 		if (argc > 0)
 		{
 			const auto* text { JS_ToCString(ctx, args[0]) };
-			textNode = std::make_shared<litehtml::el_text>(text, document);
+			textNode = document->make_element<litehtml::el_text>(text, document);
 			JS_FreeCString(ctx, text);
 		}
 		else
 		{
-			textNode = std::make_shared<litehtml::el_text>("", document);
+			textNode = document->make_element<litehtml::el_text>("", document);
 		}
 
 		document->stash_element(textNode);
@@ -195,7 +204,7 @@ litehtml::document::ptr litehtml::document::createFromUTF8(const char* str, lite
 			{
 				media = nullptr;
 			}
-			doc->m_styles.parse_stylesheet(css.text.c_str(), css.baseurl.c_str(), doc, media);
+			doc->m_styles.parse_stylesheet(css.text.c_str(), css.baseurl.c_str(), doc, media, ctx->atoms());
 		}
 		// Sort css selectors using CSS rules.
 		doc->m_styles.sort_selectors();
@@ -259,8 +268,8 @@ litehtml::uint_ptr litehtml::document::add_font( const tchar_t* name, int size,
 
 	if(m_fonts.find(key) == m_fonts.end())
 	{
-		font_style fs = (font_style) value_index(style, font_style_strings, fontStyleNormal);
-		int	fw = value_index(weight, font_weight_strings, -1);
+		font_style fs = (font_style) value_index(style, font_style_keywords, fontStyleNormal);
+		int	fw = value_index(weight, font_weight_keywords, -1);
 		if(fw >= 0)
 		{
 			switch(fw)
@@ -367,6 +376,7 @@ int litehtml::document::render( int max_width, render_type rt )
 		if(rt == render_fixed_only)
 		{
 			m_fixed_boxes.clear();
+			m_fixed_elements.clear();
 			m_root->render_positioned(rt);
 		} else
 		{
@@ -374,25 +384,49 @@ int litehtml::document::render( int max_width, render_type rt )
 			if(m_root->fetch_positioned())
 			{
 				m_fixed_boxes.clear();
+				m_fixed_elements.clear();
 				m_root->render_positioned(rt);
 			}
 			m_size.width	= 0;
 			m_size.height	= 0;
 			m_root->calc_document_size(m_size);
 		}
+		m_scrolled_fixed = !m_fixed_boxes.empty() && find_scrolled_fixed(m_root);
+		m_root->build_spatial_index();
+		m_hit_element = nullptr;
 	}
 	return ret;
 }
 
-void litehtml::document::draw( uint_ptr hdc, int x, int y, const position* clip )
+void litehtml::document::draw( uint_ptr hdc, int x, int y, const position* clip, render_type rt )
 {
 	if(m_root)
 	{
+		if(rt == render_fixed_only)
+		{
+			position client;
+			m_container->get_client_rect(client);
+			for(auto& el : m_fixed_elements)
+			{
+				draw_fixed_element(hdc, el, client.x, client.y, clip);
+			}
+			return;
+		}
+
+		// fixed elements are skipped when drawn separately over the scrolled content
+		m_draw_fixed = rt != render_no_fixed;
 		m_root->draw(hdc, x, y, clip);
 		m_root->draw_stacking_context(hdc, x, y, clip, true);
+		m_draw_fixed = true;
 	}
 }
 
+void litehtml::document::draw_fixed_element( uint_ptr hdc, const element::ptr& el, int x, int y, const position* clip )
+{
+	el->draw(hdc, x, y, clip);
+	el->draw_stacking_context(hdc, x, y, clip, true);
+}
+
 int litehtml::document::cvt_units( const tchar_t* str, int fontSize, bool* is_percent/*= 0*/ ) const
 {
 	if(!str)	return 0;
@@ -486,7 +520,7 @@ bool litehtml::document::on_mouse_over( int x, int y, int client_x, int client_y
 		return false;
 	}
 
-	element::ptr over_el = m_root->get_element_by_point(x, y, client_x, client_y);
+	element::ptr over_el = get_element_by_point(x, y, client_x, client_y);
 
 	bool state_was_changed = false;
 
@@ -517,11 +551,101 @@ bool litehtml::document::on_mouse_over( int x, int y, int client_x, int client_y
 
 	if(state_was_changed)
 	{
+		m_hit_element = nullptr;
 		return m_root->find_styles_changes(redraw_boxes, 0, 0);
 	}
 	return false;
 }
 
+litehtml::element::ptr litehtml::document::get_element_by_point(int x, int y, int client_x, int client_y)
+{
+	// Reuse the last hit element while the point stays inside the region
+	// where no other element can be hit instead of it.
+	if(m_hit_element &&
+		x > m_hit_region.left() && x < m_hit_region.right() &&
+		y > m_hit_region.top() && y < m_hit_region.bottom())
+	{
+		int el_x = x - m_hit_origin.x;
+		int el_y = y - m_hit_origin.y;
+
+		if(m_hit_element->is_point_inside(el_x, el_y) && !m_hit_element->has_child_at_point(el_x, el_y))
+		{
+			return m_hit_element;
+		}
+	}
+
+	element::ptr el = m_root->get_element_by_point(x, y, client_x, client_y);
+	cache_hit_element(el);
+	return el;
+}
+
+void litehtml::document::cache_hit_element(const element::ptr& el)
+{
+	m_hit_element = nullptr;
+
+	if(!el || el->get_element_position() == element_position_fixed)
+	{
+		return;
+	}
+
+	if(el->get_display() == display_inline || el->get_display() == display_table_row)
+	{
+		m_hit_region.clear();
+
+		position::vector boxes;
+		el->get_inline_boxes(boxes);
+		for(const auto& box : boxes)
+		{
+			spatial_index::unite(m_hit_region, box);
+		}
+	} else
+	{
+		m_hit_region = el->m_pos;
+		m_hit_region += el->m_padding;
+		m_hit_region += el->m_borders;
+	}
+
+	m_hit_origin = el->get_placement();
+	m_hit_origin.x -= el->m_pos.x;
+	m_hit_origin.y -= el->m_pos.y;
+
+	m_hit_region.x += m_hit_origin.x;
+	m_hit_region.y += m_hit_origin.y;
+
+	std::vector<const element*> ancestors;
+	for(element::ptr parent = el->parent(); parent; parent = parent->parent())
+	{
+		if(parent->get_element_position() == element_position_fixed)
+		{
+			return;
+		}
+
+		// the descendants are hit only inside the overflow clip
+		if(parent->get_overflow() > overflow_visible)
+		{
+			position clip = parent->get_placement();
+
+			int left	= std::max(m_hit_region.left(),		clip.left());
+			int top		= std::max(m_hit_region.top(),		clip.top());
+			int right	= std::min(m_hit_region.right(),	clip.right());
+			int bottom	= std::min(m_hit_region.bottom(),	clip.bottom());
+
+			m_hit_region = position(left, top, std::max(0, right - left), std::max(0, bottom - top));
+		}
+
+		ancestors.push_back(parent.get());
+	}
+
+	position region = m_hit_region;
+	region.x -= m_root->m_pos.x;
+	region.y -= m_root->m_pos.y;
+
+	if(!m_root->is_overlapped(region, el.get(), ancestors))
+	{
+		m_hit_element = el;
+	}
+}
+
 bool litehtml::document::on_mouse_leave( position::vector& redraw_boxes )
 {
 	if(!m_root)
@@ -532,6 +656,7 @@ bool litehtml::document::on_mouse_leave( position::vector& redraw_boxes )
 	{
 		if(m_over_element->on_mouse_leave())
 		{
+			m_hit_element = nullptr;
 			return m_root->find_styles_changes(redraw_boxes, 0, 0);
 		}
 	}
@@ -545,7 +670,7 @@ bool litehtml::document::on_lbutton_down( int x, int y, int client_x, int client
 		return false;
 	}
 
-	element::ptr over_el = m_root->get_element_by_point(x, y, client_x, client_y);
+	element::ptr over_el = get_element_by_point(x, y, client_x, client_y);
 
 	bool state_was_changed = false;
 
@@ -583,6 +708,7 @@ bool litehtml::document::on_lbutton_down( int x, int y, int client_x, int client
 
 	if(state_was_changed)
 	{
+		m_hit_element = nullptr;
 		return m_root->find_styles_changes(redraw_boxes, 0, 0);
 	}
 
@@ -599,6 +725,7 @@ bool litehtml::document::on_lbutton_up( int x, int y, int client_x, int client_y
 	{
 		if(m_over_element->on_lbutton_up())
 		{
+			m_hit_element = nullptr;
 			return m_root->find_styles_changes(redraw_boxes, 0, 0);
 		}
 	}
@@ -617,55 +744,55 @@ litehtml::element::ptr litehtml::document::create_element(const tchar_t* tag_nam
 	{
 		if(!t_strcmp(tag_name, _t("br")))
 		{
-			newTag = std::make_shared<litehtml::el_break>(this_doc);
+			newTag = make_element<litehtml::el_break>(this_doc);
 		} else if(!t_strcmp(tag_name, _t("p")))
 		{
-			newTag = std::make_shared<litehtml::el_para>(this_doc);
+			newTag = make_element<litehtml::el_para>(this_doc);
 		} else if(!t_strcmp(tag_name, _t("img")))
 		{
-			newTag = std::make_shared<litehtml::el_image>(this_doc);
+			newTag = make_element<litehtml::el_image>(this_doc);
 		} else if(!t_strcmp(tag_name, _t("table")))
 		{
-			newTag = std::make_shared<litehtml::el_table>(this_doc);
+			newTag = make_element<litehtml::el_table>(this_doc);
 		} else if(!t_strcmp(tag_name, _t("td")) || !t_strcmp(tag_name, _t("th")))
 		{
-			newTag = std::make_shared<litehtml::el_td>(this_doc);
+			newTag = make_element<litehtml::el_td>(this_doc);
 		} else if(!t_strcmp(tag_name, _t("link")))
 		{
-			newTag = std::make_shared<litehtml::el_link>(this_doc);
+			newTag = make_element<litehtml::el_link>(this_doc);
 		} else if(!t_strcmp(tag_name, _t("title")))
 		{
-			newTag = std::make_shared<litehtml::el_title>(this_doc);
+			newTag = make_element<litehtml::el_title>(this_doc);
 		} else if(!t_strcmp(tag_name, _t("a")))
 		{
-			newTag = std::make_shared<litehtml::el_anchor>(this_doc);
+			newTag = make_element<litehtml::el_anchor>(this_doc);
 		} else if(!t_strcmp(tag_name, _t("tr")))
 		{
-			newTag = std::make_shared<litehtml::el_tr>(this_doc);
+			newTag = make_element<litehtml::el_tr>(this_doc);
 		} else if(!t_strcmp(tag_name, _t("style")))
 		{
-			newTag = std::make_shared<litehtml::el_style>(this_doc);
+			newTag = make_element<litehtml::el_style>(this_doc);
 		} else if(!t_strcmp(tag_name, _t("base")))
 		{
-			newTag = std::make_shared<litehtml::el_base>(this_doc);
+			newTag = make_element<litehtml::el_base>(this_doc);
 		} else if(!t_strcmp(tag_name, _t("body")))
 		{
-			newTag = std::make_shared<litehtml::el_body>(this_doc);
+			newTag = make_element<litehtml::el_body>(this_doc);
 		} else if(!t_strcmp(tag_name, _t("div")))
 		{
-			newTag = std::make_shared<litehtml::el_div>(this_doc);
+			newTag = make_element<litehtml::el_div>(this_doc);
 		} else if(!t_strcmp(tag_name, _t("script")))
 		{
-			newTag = std::make_shared<litehtml::el_script>(this_doc);
+			newTag = make_element<litehtml::el_script>(this_doc);
 		} else if(!t_strcmp(tag_name, _t("font")))
 		{
-			newTag = std::make_shared<litehtml::el_font>(this_doc);
+			newTag = make_element<litehtml::el_font>(this_doc);
 		} else if(!t_strcmp(tag_name, _t("li")))
 		{
-			newTag = std::make_shared<litehtml::el_li>(this_doc);
+			newTag = make_element<litehtml::el_li>(this_doc);
 		} else
 		{
-			newTag = std::make_shared<litehtml::html_tag>(this_doc);
+			newTag = make_element<litehtml::html_tag>(this_doc);
 		}
 	}
 
@@ -694,6 +821,80 @@ void litehtml::document::add_fixed_box( const position& pos )
 	m_fixed_boxes.push_back(pos);
 }
 
+void litehtml::document::add_fixed_element( const element::ptr& el )
+{
+	// the root adds them in the drawing order
+	m_fixed_elements.push_back(el);
+}
+
+bool litehtml::document::find_scrolled_fixed( const element::ptr& el ) const
+{
+	for(size_t i = 0; i < el->get_children_count(); i++)
+	{
+		element::ptr child = el->get_child((int) i);
+		if(child->get_display() == display_none)
+		{
+			continue;
+		}
+		// the fixed descendants of a fixed element are drawn along with it
+		if(child->get_element_position() == element_position_fixed)
+		{
+			if(std::find(m_fixed_elements.begin(), m_fixed_elements.end(), child) == m_fixed_elements.end())
+			{
+				return true;
+			}
+		} else if(find_scrolled_fixed(child))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool litehtml::document::is_drawn_separately( const element::ptr& el ) const
+{
+	return !m_draw_fixed && std::find(m_fixed_elements.begin(), m_fixed_elements.end(), el) != m_fixed_elements.end();
+}
+
+void litehtml::document::add_lazy_image( const element::ptr& el )
+{
+	if(std::find(m_lazy_images.begin(), m_lazy_images.end(), el) == m_lazy_images.end())
+	{
+		m_lazy_images.push_back(el);
+	}
+}
+
+bool litehtml::document::load_lazy_images( const position& area )
+{
+	bool ret = false;
+	for(auto it = m_lazy_images.begin(); it != m_lazy_images.end();)
+	{
+		position pos = (*it)->get_placement();
+		if(pos.does_intersect(&area))
+		{
+			(*it)->load_deferred_image();
+			it = m_lazy_images.erase(it);
+			ret = true;
+		} else
+		{
+			++it;
+		}
+	}
+	return ret;
+}
+
+void litehtml::document::get_image_size( uint_ptr image, const tchar_t* src, const tchar_t* baseurl, size& sz )
+{
+	// the resolved images are looked up with no string work
+	if(image)
+	{
+		m_container->get_resolved_image_size(image, sz);
+	} else
+	{
+		m_container->get_image_size(src, baseurl, sz);
+	}
+}
+
 bool litehtml::document::media_changed()
 {
 	container()->get_media_features(m_media);
@@ -811,26 +1012,32 @@ void litehtml::document::create_node(void* gnode, elements_vector& elements, boo
 			std::wstring str_in = (const wchar_t*) (utf8_to_wchar(node->v.text.text));
 			if (!parseTextNode)
 			{
-				elements.push_back(std::make_shared<el_text>(litehtml_from_wchar(str_in).c_str(), shared_from_this()));
+				elements.push_back(make_element<el_text>(litehtml_from_wchar(str_in).c_str(), shared_from_this()));
 			}
 			else
 			{
+				// the words are kept in a single element
+				std::shared_ptr<el_text_run> run = make_element<el_text_run>(shared_from_this());
 				m_container->split_text(node->v.text.text,
-					[this, &elements](const tchar_t* text) { elements.push_back(std::make_shared<el_text>(text, shared_from_this())); },
-					[this, &elements](const tchar_t* text) { elements.push_back(std::make_shared<el_space>(text, shared_from_this())); });
+					[&run](const tchar_t* text) { run->add_word(text, false); },
+					[&run](const tchar_t* text) { run->add_word(text, true); });
+				if(!run->empty())
+				{
+					elements.push_back(std::move(run));
+				}
 			}
 		}
 		break;
 	case GUMBO_NODE_CDATA:
 		{
-			element::ptr ret = std::make_shared<el_cdata>(shared_from_this());
+			element::ptr ret = make_element<el_cdata>(shared_from_this());
 			ret->set_data(litehtml_from_utf8(node->v.text.text));
 			elements.push_back(ret);
 		}
 		break;
 	case GUMBO_NODE_COMMENT:
 		{
-			element::ptr ret = std::make_shared<el_comment>(shared_from_this());
+			element::ptr ret = make_element<el_comment>(shared_from_this());
 			ret->set_data(litehtml_from_utf8(node->v.text.text));
 			elements.push_back(ret);
 		}
@@ -838,9 +1045,14 @@ void litehtml::document::create_node(void* gnode, elements_vector& elements, boo
 	case GUMBO_NODE_WHITESPACE:
 		{
 			tstring str = litehtml_from_utf8(node->v.text.text);
+			std::shared_ptr<el_text_run> run = make_element<el_text_run>(shared_from_this());
 			for (size_t i = 0; i < str.length(); i++)
 			{
-				elements.push_back(std::make_shared<el_space>(str.substr(i, 1).c_str(), shared_from_this()));
+				run->add_word(str.substr(i, 1).c_str(), true);
+			}
+			if(!run->empty())
+			{
+				elements.push_back(std::move(run));
 			}
 		}
 		break;
@@ -901,7 +1113,7 @@ void litehtml::document::fix_table_children(element::ptr& el_ptr, style_display
 
 	auto flush_elements = [&]()
 	{
-		element::ptr annon_tag = std::make_shared<html_tag>(shared_from_this());
+		element::ptr annon_tag = make_element<html_tag>(shared_from_this());
 		annon_tag->add_style(tstring(_t("display:")) + disp_str, _t(""));
 		annon_tag->parent(el_ptr);
 		annon_tag->parse_styles();
@@ -1009,7 +1221,7 @@ void litehtml::document::fix_table_parent(element::ptr& el_ptr, style_display di
 			}
 
 			// extract elements with the same display and wrap them with anonymous object
-			element::ptr annon_tag = std::make_shared<html_tag>(shared_from_this());
+			element::ptr annon_tag = make_element<html_tag>(shared_from_this());
 			annon_tag->add_style(tstring(_t("display:")) + disp_str, _t(""));
 			annon_tag->parent(parent);
 			annon_tag->parse_styles();
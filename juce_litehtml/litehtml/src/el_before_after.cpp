@@ -1,5 +1,6 @@
 #include "html.h"
 #include "el_before_after.h"
+#include "document.h"
 #include "el_text.h"
 #include "el_space.h"
 #include "el_image.h"
@@ -9,10 +10,10 @@ litehtml::el_before_after_base::el_before_after_base(const std::shared_ptr<liteh
 {
 	if(before)
 	{
-		m_tag = _t("::before");
+		m_tag = atom_table::predefined().find(_t("::before"));
 	} else
 	{
-        m_tag = _t("::after");
+        m_tag = atom_table::predefined().find(_t("::after"));
 	}
 }
 
@@ -23,7 +24,7 @@ void litehtml::el_before_after_base::add_style(const tstring& style, const tstri
 	auto children = m_children;
 	m_children.clear();
 
-	tstring content = get_style_property(_t("content"), false, _t(""));
+	tstring content = get_style_property(css_property_content, false, _t(""));
 	if(!content.empty())
 	{
 		int idx = value_index(content, content_property_string);
@@ -94,12 +95,12 @@ void litehtml::el_before_after_base::add_text( const tstring& txt )
 			{
 				if(!word.empty())
 				{
-					element::ptr el = std::make_shared<el_text>(word.c_str(), get_document());
+					element::ptr el = document_ptr()->make_element<el_text>(word.c_str(), get_document());
 					appendChild(el);
 					word.clear();
 				}
 
-				element::ptr el = std::make_shared<el_space>(txt.substr(i, 1).c_str(), get_document());
+				element::ptr el = document_ptr()->make_element<el_space>(txt.substr(i, 1).c_str(), get_document());
 				appendChild(el);
 			} else
 			{
@@ -128,7 +129,7 @@ void litehtml::el_before_after_base::add_text( const tstring& txt )
 	}
 	if(!word.empty())
 	{
-		element::ptr el = std::make_shared<el_text>(word.c_str(), get_document());
+		element::ptr el = document_ptr()->make_element<el_text>(word.c_str(), get_document());
 		appendChild(el);
 		word.clear();
 	}
@@ -180,7 +181,7 @@ void litehtml::el_before_after_base::add_function( const tstring& fnc, const tst
 			}
 			if(!p_url.empty())
 			{
-				element::ptr el = std::make_shared<el_image>(get_document());
+				element::ptr el = document_ptr()->make_element<el_image>(get_document());
 				el->set_attr(_t("src"), p_url.c_str());
 				el->set_attr(_t("style"), _t("display:inline-block"));
 				el->set_tagName(_t("img"));
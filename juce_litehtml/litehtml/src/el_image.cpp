@@ -5,6 +5,8 @@
 litehtml::el_image::el_image(const std::shared_ptr<litehtml::document>& doc) : html_tag(doc)
 {
 	m_display = display_inline_block;
+	m_image_requested = false;
+	m_image_handle = 0;
 }
 
 litehtml::el_image::~el_image( void )
@@ -14,7 +16,7 @@ litehtml::el_image::~el_image( void )
 
 void litehtml::el_image::get_content_size( size& sz, int max_width )
 {
-	get_document()->container()->get_image_size(m_src.c_str(), 0, sz);
+	get_document()->get_image_size(m_image_handle, m_src.c_str(), 0, sz);
 }
 
 int litehtml::el_image::calc_max_height(int image_height)
@@ -56,7 +58,7 @@ int litehtml::el_image::render( int x, int y, int max_width, bool second_pass )
 	document::ptr doc = get_document();
 
 	litehtml::size sz;
-	doc->container()->get_image_size(m_src.c_str(), 0, sz);
+	doc->get_image_size(m_image_handle, m_src.c_str(), 0, sz);
 
 	m_pos.width		= sz.width;
 	m_pos.height	= sz.height;
@@ -185,6 +187,7 @@ int litehtml::el_image::render( int x, int y, int max_width, bool second_pass )
 void litehtml::el_image::parse_attributes()
 {
 	m_src = get_attr(_t("src"), _t(""));
+	m_image_handle = 0;
 
 	const tchar_t* attr_height = get_attr(_t("height"));
 	if(attr_height)
@@ -227,6 +230,7 @@ void litehtml::el_image::draw( uint_ptr hdc, int x, int y, const position* clip
 		if (pos.width > 0 && pos.height > 0) {
 			background_paint bg;
 			bg.image				= m_src;
+			bg.image_handle			= m_image_handle;
 			bg.clip_box				= pos;
 			bg.origin_box			= pos;
 			bg.border_box			= pos;
@@ -262,12 +266,57 @@ void litehtml::el_image::parse_styles( bool is_reparse /*= false*/ )
 
 	if(!m_src.empty())
 	{
-		if(!m_css_height.is_predefined() && !m_css_width.is_predefined())
+		if(!m_image_handle)
 		{
-			get_document()->container()->load_image(m_src.c_str(), nullptr, true);
+			m_image_handle = get_document()->container()->resolve_image(m_src.c_str(), nullptr);
+		}
+
+		// the lazy images are requested once they get near the viewport,
+		// until then they are sized from the attributes or the image header
+		if(!m_image_requested && is_lazy())
+		{
+			get_document()->add_lazy_image(shared_from_this());
 		} else
 		{
-			get_document()->container()->load_image(m_src.c_str(), nullptr, false);
+			request_image();
 		}
 	}
 }
+
+void litehtml::el_image::load_deferred_image()
+{
+	if(!m_image_requested && !m_src.empty())
+	{
+		request_image();
+	}
+}
+
+bool litehtml::el_image::is_lazy() const
+{
+	const tchar_t* loading = get_attr(_t("loading"));
+	if(loading)
+	{
+		if(!t_strcasecmp(loading, _t("lazy")))
+		{
+			return true;
+		}
+		if(!t_strcasecmp(loading, _t("eager")))
+		{
+			return false;
+		}
+	}
+	return get_document()->container()->lazy_load_images();
+}
+
+void litehtml::el_image::request_image()
+{
+	m_image_requested = true;
+
+	if(!m_css_height.is_predefined() && !m_css_width.is_predefined())
+	{
+		get_document()->container()->load_image(m_src.c_str(), nullptr, true);
+	} else
+	{
+		get_document()->container()->load_image(m_src.c_str(), nullptr, false);
+	}
+}
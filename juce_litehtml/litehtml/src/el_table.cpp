@@ -29,12 +29,12 @@ void litehtml::el_table::parse_styles(bool is_reparse)
 {
 	html_tag::parse_styles(is_reparse);
 
-	m_border_collapse = (border_collapse) value_index(get_style_property(_t("border-collapse"), true, _t("separate")), border_collapse_strings, border_collapse_separate);
+	m_border_collapse = (border_collapse) value_index(get_style_property(css_property_border_collapse, true, _t("separate")), border_collapse_keywords, border_collapse_separate);
 
 	if(m_border_collapse == border_collapse_separate)
 	{
-		m_css_border_spacing_x.fromString(get_style_property(_t("-litehtml-border-spacing-x"), true, _t("0px")));
-		m_css_border_spacing_y.fromString(get_style_property(_t("-litehtml-border-spacing-y"), true, _t("0px")));
+		m_css_border_spacing_x.fromString(get_style_property(css_property_litehtml_border_spacing_x, true, _t("0px")));
+		m_css_border_spacing_y.fromString(get_style_property(css_property_litehtml_border_spacing_y, true, _t("0px")));
 
 		int fntsz = get_font_size();
 		document::ptr doc = get_document();
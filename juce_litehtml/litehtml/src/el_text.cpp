@@ -23,11 +23,24 @@ void litehtml::el_text::get_text( tstring& text )
 	text += m_text;
 }
 
+const litehtml::tchar_t* litehtml::el_text::get_style_property( css_property id, bool inherited, const tchar_t* def /*= 0*/ ) const
+{
+	if(inherited)
+	{
+		element* el_parent = parent_ptr();
+		if (el_parent)
+		{
+			return el_parent->get_style_property(id, inherited, def);
+		}
+	}
+	return def;
+}
+
 const litehtml::tchar_t* litehtml::el_text::get_style_property( const tchar_t* name, bool inherited, const tchar_t* def /*= 0*/ ) const
 {
 	if(inherited)
 	{
-		element::ptr el_parent = parent();
+		element* el_parent = parent_ptr();
 		if (el_parent)
 		{
 			return el_parent->get_style_property(name, inherited, def);
@@ -36,14 +49,23 @@ const litehtml::tchar_t* litehtml::el_text::get_style_property( const tchar_t* n
 	return def;
 }
 
-void litehtml::el_text::parse_styles(bool is_reparse)
+const litehtml::tchar_t* litehtml::el_text::get_draw_text() const
+{
+	if(is_break())
+	{
+		return nullptr;
+	}
+	return m_use_transformed ? m_transformed_text.c_str() : m_text.c_str();
+}
+
+bool litehtml::el_text::parse_text_styles(std::vector<const tchar_t*>& texts)
 {
-	m_text_transform	= (text_transform)	value_index(get_style_property(_t("text-transform"), true,	_t("none")),	text_transform_strings,	text_transform_none);
+	m_text_transform	= (text_transform)	value_index(get_style_property(css_property_text_transform, true,	_t("none")),	text_transform_keywords,	text_transform_none);
 	if(m_text_transform != text_transform_none)
 	{
 		m_transformed_text	= m_text;
 		m_use_transformed = true;
-		get_document()->container()->transform_text(m_transformed_text, m_text_transform);
+		document_ptr()->container()->transform_text(m_transformed_text, m_text_transform);
 	}
 
 	if(is_white_space())
@@ -65,11 +87,10 @@ void litehtml::el_text::parse_styles(bool is_reparse)
 	}
 
 	font_metrics fm;
-	uint_ptr font = 0;
-	element::ptr el_parent = parent();
+	element* el_parent = parent_ptr();
 	if (el_parent)
 	{
-		font = el_parent->get_font(&fm);
+		el_parent->get_font(&fm);
 	}
 	if(is_break())
 	{
@@ -78,14 +99,34 @@ void litehtml::el_text::parse_styles(bool is_reparse)
 	} else
 	{
 		m_size.height	= fm.height;
-		m_size.width	= get_document()->container()->text_width(m_use_transformed ? m_transformed_text.c_str() : m_text.c_str(), font);
+		texts.push_back(m_use_transformed ? m_transformed_text.c_str() : m_text.c_str());
 	}
 	m_draw_spaces = fm.draw_spaces;
+	return true;
+}
+
+void litehtml::el_text::parse_styles(bool is_reparse)
+{
+	std::vector<const tchar_t*> texts;
+	parse_text_styles(texts);
+
+	if(!texts.empty())
+	{
+		std::vector<int> widths(texts.size(), 0);
+		document_ptr()->container()->text_widths(texts.data(), texts.size(), get_font(), widths.data());
+		set_text_widths(widths.data());
+	}
 }
 
+void litehtml::el_text::set_text_widths(const int* widths)
+{
+	m_size.width = widths[0];
+}
+
+
 int litehtml::el_text::get_base_line()
 {
-	element::ptr el_parent = parent();
+	element* el_parent = parent_ptr();
 	if (el_parent)
 	{
 		return el_parent->get_base_line();
@@ -106,13 +147,13 @@ void litehtml::el_text::draw( uint_ptr hdc, int x, int y, const position* clip )
 
 	if(pos.does_intersect(clip))
 	{
-		element::ptr el_parent = parent();
+		element* el_parent = parent_ptr();
 		if (el_parent)
 		{
 			document::ptr doc = get_document();
 
 			uint_ptr font = el_parent->get_font();
-			litehtml::web_color color = el_parent->get_color(_t("color"), true, doc->get_def_color());
+			litehtml::web_color color = el_parent->get_color(css_property_color, true, doc->get_def_color());
 			doc->container()->draw_text(hdc, m_use_transformed ? m_transformed_text.c_str() : m_text.c_str(), font, color, pos);
 		}
 	}
@@ -120,7 +161,7 @@ void litehtml::el_text::draw( uint_ptr hdc, int x, int y, const position* clip )
 
 int litehtml::el_text::line_height() const
 {
-	element::ptr el_parent = parent();
+	element* el_parent = parent_ptr();
 	if (el_parent)
 	{
 		return el_parent->line_height();
@@ -130,7 +171,7 @@ int litehtml::el_text::line_height() const
 
 litehtml::uint_ptr litehtml::el_text::get_font( font_metrics* fm /*= 0*/ )
 {
-	element::ptr el_parent = parent();
+	element* el_parent = parent_ptr();
 	if (el_parent)
 	{
 		return el_parent->get_font(fm);
@@ -145,14 +186,14 @@ litehtml::style_display litehtml::el_text::get_display() const
 
 litehtml::white_space litehtml::el_text::get_white_space() const
 {
-	element::ptr el_parent = parent();
+	element* el_parent = parent_ptr();
 	if (el_parent) return el_parent->get_white_space();
 	return white_space_normal;
 }
 
 litehtml::element_position litehtml::el_text::get_element_position(css_offsets* offsets) const
 {
-	element::ptr p = parent();
+	const element* p = parent_ptr();
 	while(p && p->get_display() == display_inline)
 	{
 		if(p->get_element_position() == element_position_relative)
@@ -163,21 +204,21 @@ litehtml::element_position litehtml::el_text::get_element_position(css_offsets*
 			}
 			return element_position_relative;
 		}
-		p = p->parent();
+		p = p->parent_ptr();
 	}
 	return element_position_static;
 }
 
 litehtml::css_offsets litehtml::el_text::get_css_offsets() const
 {
-	element::ptr p = parent();
+	const element* p = parent_ptr();
 	while(p && p->get_display() == display_inline)
 	{
 		if(p->get_element_position() == element_position_relative)
 		{
 			return p->get_css_offsets();
 		}
-		p = p->parent();
+		p = p->parent_ptr();
 	}
 	return {};
 }
@@ -0,0 +1,536 @@
+#include "html.h"
+#include "el_text_run.h"
+#include "document.h"
+
+litehtml::el_text_fragment::el_text_fragment(el_text_run* run, const std::shared_ptr<litehtml::document>& doc) : el_text(nullptr, doc)
+{
+	m_run		= run;
+	m_first		= 0;
+	m_last		= 0;
+	m_run_id	= 0;
+}
+
+void litehtml::el_text_fragment::get_content_size(size& sz, int max_width)
+{
+	sz.width	= m_run->get_words_width(m_first, m_last);
+	sz.height	= is_break() ? 0 : m_run->m_size.height;
+}
+
+bool litehtml::el_text_fragment::is_white_space() const
+{
+	return m_first == m_last && m_run->is_white_space_word(m_first, get_white_space());
+}
+
+bool litehtml::el_text_fragment::is_break() const
+{
+	return m_first == m_last && m_run->is_break_word(m_first, get_white_space());
+}
+
+bool litehtml::el_text_fragment::is_space() const
+{
+	return m_first == m_last && m_run->m_words[m_first].space;
+}
+
+const litehtml::tchar_t* litehtml::el_text_fragment::get_draw_text() const
+{
+	return nullptr;
+}
+
+void litehtml::el_text_fragment::draw(uint_ptr hdc, int x, int y, const position* clip)
+{
+	m_run->draw_words(hdc, x, y, clip, m_pos, m_first, m_last, m_run_id);
+}
+
+bool litehtml::el_text_fragment::is_first_fragment(const element* run) const
+{
+	return run == m_run && m_first <= m_run->m_first_solid && m_run->m_first_solid <= m_last;
+}
+
+bool litehtml::el_text_fragment::is_last_fragment(const element* run) const
+{
+	return run == m_run && m_first <= m_run->m_last_solid && m_run->m_last_solid <= m_last;
+}
+
+bool litehtml::el_text_fragment::merge_fragment(const element::ptr& el)
+{
+	return m_run->merge_fragments(this, el);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+litehtml::el_text_run::el_text_run(const std::shared_ptr<litehtml::document>& doc) : el_text(nullptr, doc)
+{
+	m_first_solid	= tstring::npos;
+	m_last_solid	= tstring::npos;
+}
+
+void litehtml::el_text_run::add_word(const tchar_t* text, bool space)
+{
+	text_word word;
+	word.offset			= (unsigned int) m_text.length();
+	word.draw_offset	= 0;
+	word.width			= 0;
+	word.space			= space;
+	word.placed			= false;
+	m_words.push_back(word);
+
+	m_text += text;
+	m_text += _t('\0');
+}
+
+void litehtml::el_text_run::get_text(tstring& text)
+{
+	for(const auto& word : m_words)
+	{
+		text += m_text.c_str() + word.offset;
+	}
+}
+
+const litehtml::tchar_t* litehtml::el_text_run::get_draw_text() const
+{
+	return nullptr;
+}
+
+bool litehtml::el_text_run::parse_text_styles(std::vector<const tchar_t*>& texts)
+{
+	m_text_transform	= (text_transform)	value_index(get_style_property(css_property_text_transform, true,	_t("none")),	text_transform_keywords,	text_transform_none);
+	m_use_transformed	= m_text_transform != text_transform_none;
+	m_transformed_text.clear();
+
+	if(m_use_transformed)
+	{
+		// the words are transformed one by one, as the separate text elements used to be
+		document_container* container = document_ptr()->container();
+		tstring text;
+		for(auto& word : m_words)
+		{
+			word.draw_offset = (unsigned int) m_transformed_text.length();
+			if(!word.space)
+			{
+				text = m_text.c_str() + word.offset;
+				container->transform_text(text, m_text_transform);
+				m_transformed_text += text;
+			}
+			m_transformed_text += _t('\0');
+		}
+	}
+
+	font_metrics fm;
+	element* el_parent = parent_ptr();
+	if (el_parent)
+	{
+		el_parent->get_font(&fm);
+	}
+	m_size.height	= fm.height;
+	m_size.width	= 0;
+	m_draw_spaces	= fm.draw_spaces;
+
+	white_space ws = get_white_space();
+	for(size_t i = 0; i < m_words.size(); i++)
+	{
+		if(is_break_word(i, ws))
+		{
+			m_words[i].width = 0;
+		} else
+		{
+			texts.push_back(get_word_text(i, ws));
+		}
+	}
+	return true;
+}
+
+void litehtml::el_text_run::set_text_widths(const int* widths)
+{
+	white_space ws = get_white_space();
+	for(size_t i = 0; i < m_words.size(); i++)
+	{
+		if(!is_break_word(i, ws))
+		{
+			m_words[i].width = *widths++;
+		}
+	}
+}
+
+bool litehtml::el_text_run::is_white_space() const
+{
+	if(m_words.empty() || !collapse_spaces(get_white_space()))
+	{
+		return false;
+	}
+	for(const auto& word : m_words)
+	{
+		if(!word.space)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool litehtml::el_text_run::is_break() const
+{
+	return m_words.size() == 1 && is_break_word(0, get_white_space());
+}
+
+bool litehtml::el_text_run::is_space() const
+{
+	if(m_words.empty())
+	{
+		return false;
+	}
+	for(const auto& word : m_words)
+	{
+		if(!word.space)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool litehtml::el_text_run::is_text_run() const
+{
+	// a single word does not need fragments
+	return m_words.size() > 1;
+}
+
+bool litehtml::el_text_run::have_inline_child() const
+{
+	return !is_white_space();
+}
+
+int litehtml::el_text_run::render_inline(const element::ptr& container, int max_width)
+{
+	m_skip = false;
+
+	elements_vector& spare = document_ptr()->spare_fragments();
+	spare.insert(spare.end(), m_fragments.begin(), m_fragments.end());
+	m_fragments.clear();
+
+	white_space ws = get_white_space();
+	bool skip_spaces = collapse_spaces(ws);
+
+	m_first_solid	= tstring::npos;
+	m_last_solid	= tstring::npos;
+	for(size_t i = 0; i < m_words.size(); i++)
+	{
+		m_words[i].placed = false;
+		if(!is_white_space_word(i, ws))
+		{
+			if(m_first_solid == tstring::npos)
+			{
+				m_first_solid = i;
+			}
+			m_last_solid = i;
+		}
+	}
+
+	int ret_width = 0;
+	bool was_space = false;
+
+	for(size_t i = 0; i < m_words.size(); i++)
+	{
+		// skip spaces to make rendering a bit faster
+		if(skip_spaces)
+		{
+			if(m_words[i].space)
+			{
+				if(was_space)
+				{
+					continue;
+				}
+				was_space = true;
+			} else
+			{
+				was_space = false;
+			}
+		}
+
+		// finishing a line merges (and removes) the fragments, so the fragment is held here
+		m_words[i].placed = true;
+		element::ptr frag = new_fragment(i);
+		m_fragments.push_back(frag);
+
+		int rw = container->place_element(frag, max_width);
+		if(rw > ret_width)
+		{
+			ret_width = rw;
+		}
+	}
+	return ret_width;
+}
+
+size_t litehtml::el_text_run::get_fragments_count() const
+{
+	return m_fragments.size();
+}
+
+litehtml::element::ptr litehtml::el_text_run::get_fragment(size_t idx) const
+{
+	return m_fragments[idx];
+}
+
+void litehtml::el_text_run::draw(uint_ptr hdc, int x, int y, const position* clip)
+{
+	if(!is_text_run())
+	{
+		if(!m_words.empty())
+		{
+			draw_words(hdc, x, y, clip, m_pos, 0, 0, 0);
+		}
+		return;
+	}
+	for(const auto& frag : m_fragments)
+	{
+		if(frag->is_visible())
+		{
+			frag->draw(hdc, x, y, clip);
+		}
+	}
+}
+
+bool litehtml::el_text_run::is_point_inside(int x, int y)
+{
+	if(!is_text_run())
+	{
+		return el_text::is_point_inside(x, y);
+	}
+	for(const auto& frag : m_fragments)
+	{
+		if(frag->is_visible() && frag->is_point_inside(x, y))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void litehtml::el_text_run::calc_document_size(litehtml::size& sz, int x, int y)
+{
+	if(!is_text_run())
+	{
+		el_text::calc_document_size(sz, x, y);
+	} else if(is_visible())
+	{
+		for(const auto& frag : m_fragments)
+		{
+			frag->calc_document_size(sz, x, y);
+		}
+	}
+}
+
+void litehtml::el_text_run::get_redraw_box(litehtml::position& pos, int x, int y)
+{
+	if(!is_text_run())
+	{
+		el_text::get_redraw_box(pos, x, y);
+	} else if(is_visible())
+	{
+		for(const auto& frag : m_fragments)
+		{
+			frag->get_redraw_box(pos, x, y);
+		}
+	}
+}
+
+litehtml::position litehtml::el_text_run::build_spatial_index()
+{
+	if(!is_text_run())
+	{
+		return el_text::build_spatial_index();
+	}
+	position ink;
+	if(!is_visible())
+	{
+		return ink;
+	}
+	for(const auto& frag : m_fragments)
+	{
+		if(frag->is_visible())
+		{
+			spatial_index::unite(ink, frag->build_spatial_index());
+		}
+	}
+	return ink;
+}
+
+void litehtml::el_text_run::get_content_size(size& sz, int max_width)
+{
+	sz.width	= m_words.empty() ? 0 : m_words.front().width;
+	sz.height	= is_break() ? 0 : m_size.height;
+}
+
+bool litehtml::el_text_run::collapse_spaces(white_space ws)
+{
+	return	ws == white_space_normal ||
+			ws == white_space_nowrap ||
+			ws == white_space_pre_line;
+}
+
+bool litehtml::el_text_run::is_white_space_word(size_t idx, white_space ws) const
+{
+	return m_words[idx].space && collapse_spaces(ws);
+}
+
+bool litehtml::el_text_run::is_break_word(size_t idx, white_space ws) const
+{
+	if(	ws == white_space_pre ||
+		ws == white_space_pre_line ||
+		ws == white_space_pre_wrap)
+	{
+		return m_words[idx].space && m_text[m_words[idx].offset] == _t('\n');
+	}
+	return false;
+}
+
+const litehtml::tchar_t* litehtml::el_text_run::get_word_text(size_t idx, white_space ws) const
+{
+	const text_word& word = m_words[idx];
+	if(word.space)
+	{
+		if(collapse_spaces(ws))
+		{
+			return _t(" ");
+		}
+		tchar_t c = m_text[word.offset];
+		if(c == _t('\t'))
+		{
+			return _t("    ");
+		}
+		if(c == _t('\n') || c == _t('\r'))
+		{
+			return _t("");
+		}
+	} else if(m_use_transformed)
+	{
+		return m_transformed_text.c_str() + word.draw_offset;
+	}
+	return m_text.c_str() + word.offset;
+}
+
+int litehtml::el_text_run::get_words_width(size_t first, size_t last) const
+{
+	int width = 0;
+	for(size_t i = first; i <= last; i++)
+	{
+		if(m_words[i].placed)
+		{
+			width += m_words[i].width;
+		}
+	}
+	return width;
+}
+
+litehtml::element::ptr litehtml::el_text_run::new_fragment(size_t idx)
+{
+	element::ptr frag;
+	elements_vector& spare = document_ptr()->spare_fragments();
+	if(!spare.empty())
+	{
+		frag = std::move(spare.back());
+		spare.pop_back();
+	} else
+	{
+		frag = document_ptr()->make_element<el_text_fragment>(this, get_document());
+	}
+
+	// fragments are styled and positioned as the words of the run parent
+	frag->parent(parent());
+
+	auto fragment		= static_cast<el_text_fragment*>(frag.get());
+	fragment->m_run		= this;
+	fragment->m_first	= idx;
+	fragment->m_last	= idx;
+	fragment->m_run_id	= 0;
+	fragment->m_skip	= false;
+	fragment->m_box		= nullptr;
+	fragment->m_pos		= position();
+	return frag;
+}
+
+bool litehtml::el_text_run::merge_fragments(el_text_fragment* frag, const element::ptr& el)
+{
+	// the lines are finished in order, so the fragment is close to the end
+	size_t idx = m_fragments.size();
+	while(idx > 0 && m_fragments[idx - 1].get() != frag)
+	{
+		idx--;
+	}
+	if(idx == 0 || idx == m_fragments.size() || m_fragments[idx] != el)
+	{
+		return false;
+	}
+
+	auto next_frag = static_cast<el_text_fragment*>(el.get());
+	const position& next = next_frag->m_pos;
+	if(next.x != frag->m_pos.right() || next.y != frag->m_pos.y || next.height != frag->m_pos.height)
+	{
+		return false;
+	}
+
+	if(frag->m_first == frag->m_last)
+	{
+		frag->m_run_id = text_run::new_id();
+	}
+	frag->m_last		= next_frag->m_last;
+	frag->m_pos.width	= next.right() - frag->m_pos.x;
+
+	document_ptr()->spare_fragments().push_back(std::move(m_fragments[idx]));
+	m_fragments.erase(m_fragments.begin() + idx);
+	return true;
+}
+
+void litehtml::el_text_run::draw_words(uint_ptr hdc, int x, int y, const position* clip, const position& words_pos, size_t first, size_t last, size_t run_id)
+{
+	white_space ws = get_white_space();
+	if(first == last && is_white_space_word(first, ws) && !m_draw_spaces)
+	{
+		return;
+	}
+
+	position pos = words_pos;
+	pos.x	+= x;
+	pos.y	+= y;
+
+	element* el_parent = parent_ptr();
+	if(!el_parent || !pos.does_intersect(clip))
+	{
+		return;
+	}
+
+	document* doc = document_ptr();
+	uint_ptr font = el_parent->get_font();
+	web_color color = el_parent->get_color(css_property_color, true, doc->get_def_color());
+
+	if(first == last)
+	{
+		doc->container()->draw_text(hdc, get_word_text(first, ws), font, color, pos);
+		return;
+	}
+
+	text_run run;
+	run.id		= run_id;
+	run.first	= first;
+	run.last	= last;
+	run.pos		= words_pos;
+
+	int part_x = 0;
+	for(size_t i = first; i <= last; i++)
+	{
+		const text_word& word = m_words[i];
+		if(!word.placed)
+		{
+			continue;
+		}
+		if(m_draw_spaces || !is_white_space_word(i, ws))
+		{
+			text_run_part part;
+			part.text	= get_word_text(i, ws);
+			part.x		= part_x;
+			part.width	= word.width;
+			run.parts.push_back(std::move(part));
+		}
+		part_x += word.width;
+	}
+	doc->container()->draw_text_run(hdc, run, font, color, pos);
+}
@@ -21,6 +21,8 @@ litehtml::element::js_object_ref::~js_object_ref()
 
 litehtml::element::element(const std::shared_ptr<litehtml::document>& doc) : m_doc(doc)
 {
+	m_parent_ptr	= nullptr;
+	m_doc_ptr		= doc.get();
 	m_box		= nullptr;
 	m_skip		= false;
 
@@ -30,6 +32,15 @@ litehtml::element::element(const std::shared_ptr<litehtml::document>& doc) : m_d
 
 litehtml::element::~element()
 {
+	// the children kept alive elsewhere must not point to this element
+	for(auto& el : m_children)
+	{
+		if(el->m_parent_ptr == this)
+		{
+			el->m_parent_ptr = nullptr;
+		}
+	}
+
 	if (m_jsValue == JS_UNINITIALIZED || m_jsContext == nullptr)
 		return;
 
@@ -220,9 +231,9 @@ bool litehtml::element::is_point_inside( int x, int y )
 	return false;
 }
 
-litehtml::web_color litehtml::element::get_color( const tchar_t* prop_name, bool inherited, const litehtml::web_color& def_color )
+litehtml::web_color litehtml::element::get_color( css_property prop, bool inherited, const litehtml::web_color& def_color )
 {
-	const tchar_t* clrstr = get_style_property(prop_name, inherited, nullptr);
+	const tchar_t* clrstr = get_style_property(prop, inherited, nullptr);
 	if(!clrstr)
 	{
 		return def_color;
@@ -233,12 +244,12 @@ litehtml::web_color litehtml::element::get_color( const tchar_t* prop_name, bool
 litehtml::position litehtml::element::get_placement() const
 {
 	litehtml::position pos = m_pos;
-	element::ptr cur_el = parent();
+	const element* cur_el = parent_ptr();
 	while(cur_el)
 	{
 		pos.x += cur_el->m_pos.x;
 		pos.y += cur_el->m_pos.y;
-		cur_el = cur_el->parent();
+		cur_el = cur_el->parent_ptr();
 	}
 	return pos;
 }
@@ -338,6 +349,24 @@ void litehtml::element::get_redraw_box(litehtml::position& pos, int x /*= 0*/, i
 	}
 }
 
+litehtml::position litehtml::element::build_spatial_index()
+{
+	position ink = m_pos;
+	ink += m_padding;
+	ink += m_borders;
+	return ink;
+}
+
+bool litehtml::element::has_child_at_point(int x, int y) const
+{
+	return !m_children.empty();
+}
+
+bool litehtml::element::is_overlapped(const position& region, const element* target, const std::vector<const element*>& ancestors) const
+{
+	return !m_children.empty();
+}
+
 int litehtml::element::calc_width(int defVal) const
 {
 	css_length w = get_css_width();
@@ -368,10 +397,10 @@ int litehtml::element::calc_width(int defVal) const
 
 bool litehtml::element::is_ancestor(const ptr &el) const
 {
-	element::ptr el_parent = parent();
-	while(el_parent && el_parent != el)
+	const element* el_parent = parent_ptr();
+	while(el_parent && el_parent != el.get())
 	{
-		el_parent = el_parent->parent();
+		el_parent = el_parent->parent_ptr();
 	}
 	if(el_parent)
 	{
@@ -496,6 +525,7 @@ litehtml::element::ptr litehtml::element::get_element_by_point(int x, int y, int
 litehtml::element::ptr litehtml::element::get_child_by_point(int x, int y, int client_x, int client_y, draw_flag flag, int zindex) LITEHTML_RETURN_FUNC(nullptr)
 void litehtml::element::get_line_left_right( int y, int def_right, int& ln_left, int& ln_right ) LITEHTML_EMPTY_FUNC
 void litehtml::element::add_style( const tstring& style, const tstring& baseurl )						LITEHTML_EMPTY_FUNC
+void litehtml::element::add_ancestor_keys( ancestor_filter& filter ) const							LITEHTML_EMPTY_FUNC
 void litehtml::element::select_all(const css_selector& selector, litehtml::elements_vector& res)	LITEHTML_EMPTY_FUNC
 litehtml::elements_vector litehtml::element::select_all(const litehtml::css_selector& selector)	 LITEHTML_RETURN_FUNC(litehtml::elements_vector())
 litehtml::elements_vector litehtml::element::select_all(const litehtml::tstring& selector)			 LITEHTML_RETURN_FUNC(litehtml::elements_vector())
@@ -556,6 +586,9 @@ void litehtml::element::on_click()													LITEHTML_EMPTY_FUNC
 void litehtml::element::init_font()													LITEHTML_EMPTY_FUNC
 void litehtml::element::get_inline_boxes( position::vector& boxes )					LITEHTML_EMPTY_FUNC
 void litehtml::element::parse_styles( bool is_reparse /*= false*/ )					LITEHTML_EMPTY_FUNC
+bool litehtml::element::parse_text_styles( std::vector<const tchar_t*>& texts )	LITEHTML_RETURN_FUNC(false)
+void litehtml::element::set_text_widths( const int* widths )						LITEHTML_EMPTY_FUNC
+void litehtml::element::load_deferred_image()										LITEHTML_EMPTY_FUNC
 const litehtml::tchar_t* litehtml::element::get_attr( const tchar_t* name, const tchar_t* def /*= 0*/ ) const LITEHTML_RETURN_FUNC(def)
 bool litehtml::element::is_white_space() const										LITEHTML_RETURN_FUNC(false)
 bool litehtml::element::is_space() const										    LITEHTML_RETURN_FUNC(false)
@@ -578,9 +611,18 @@ bool litehtml::element::is_replaced() const											LITEHTML_RETURN_FUNC(false
 int litehtml::element::line_height() const											LITEHTML_RETURN_FUNC(0)
 void litehtml::element::draw( uint_ptr hdc, int x, int y, const position* clip )	LITEHTML_EMPTY_FUNC
 void litehtml::element::draw_background( uint_ptr hdc, int x, int y, const position* clip )	LITEHTML_EMPTY_FUNC
+const litehtml::tchar_t* litehtml::element::get_style_property( css_property id, bool inherited, const tchar_t* def /*= 0*/ ) const	LITEHTML_RETURN_FUNC(nullptr)
 const litehtml::tchar_t* litehtml::element::get_style_property( const tchar_t* name, bool inherited, const tchar_t* def /*= 0*/ ) const	LITEHTML_RETURN_FUNC(nullptr)
+
+const litehtml::computed_style::ptr& litehtml::element::get_computed_style() const
+{
+	static const computed_style::ptr empty;
+	return empty;
+}
+
 litehtml::uint_ptr litehtml::element::get_font( font_metrics* fm /*= 0*/ )			LITEHTML_RETURN_FUNC(0)
 int litehtml::element::get_font_size()	const										LITEHTML_RETURN_FUNC(0)
+const litehtml::tchar_t* litehtml::element::get_draw_text() const					LITEHTML_RETURN_FUNC(nullptr)
 void litehtml::element::get_text( tstring& text )									LITEHTML_EMPTY_FUNC
 void litehtml::element::parse_attributes()											LITEHTML_EMPTY_FUNC
 int litehtml::element::select( const css_selector& selector, bool apply_pseudo)		LITEHTML_RETURN_FUNC(select_no_match)
@@ -589,3 +631,9 @@ litehtml::element::ptr litehtml::element::find_ancestor(const css_selector& sele
 bool litehtml::element::is_first_child_inline(const element::ptr& el) const			LITEHTML_RETURN_FUNC(false)
 bool litehtml::element::is_last_child_inline(const element::ptr& el)				LITEHTML_RETURN_FUNC(false)
 bool litehtml::element::have_inline_child() const									LITEHTML_RETURN_FUNC(false)
+bool litehtml::element::is_text_run() const											LITEHTML_RETURN_FUNC(false)
+size_t litehtml::element::get_fragments_count() const								LITEHTML_RETURN_FUNC(0)
+litehtml::element::ptr litehtml::element::get_fragment(size_t idx) const			LITEHTML_RETURN_FUNC(nullptr)
+bool litehtml::element::is_first_fragment(const element* run) const				LITEHTML_RETURN_FUNC(false)
+bool litehtml::element::is_last_fragment(const element* run) const					LITEHTML_RETURN_FUNC(false)
+bool litehtml::element::merge_fragment(const element::ptr& el)						LITEHTML_RETURN_FUNC(false)
@@ -1,6 +1,7 @@
 #include "html.h"
 #include "types.h"
 #include "utf8_strings.h"
+#include <atomic>
 
 void litehtml::trim(tstring &s) 
 {
@@ -66,7 +67,7 @@ int litehtml::value_index( const tstring& val, const tstring& strings, int defVa
 		}
 		if(item_len == val.length())
 		{
-			if(val == strings.substr(delim_start, item_len))
+			if(!strings.compare(delim_start, item_len, val))
 			{
 				return idx;
 			}
@@ -202,6 +203,40 @@ int litehtml::t_strncasecmp(const litehtml::tchar_t *s1, const litehtml::tchar_t
 	return 0;
 }
 
+void litehtml::document_container::text_widths(const tchar_t* const* texts, size_t count, uint_ptr hFont, int* widths)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		widths[i] = text_width(texts[i], hFont);
+	}
+}
+
+litehtml::uint_ptr litehtml::document_container::resolve_image(const tchar_t* src, const tchar_t* baseurl)
+{
+	return 0;
+}
+
+void litehtml::document_container::get_resolved_image_size(uint_ptr image, size& sz)
+{
+	sz.width	= 0;
+	sz.height	= 0;
+}
+
+void litehtml::document_container::draw_text_run(uint_ptr hdc, const text_run& run, uint_ptr hFont, web_color color, const position& pos)
+{
+	for(const auto& part : run.parts)
+	{
+		position part_pos(pos.x + part.x, pos.y, part.width, pos.height);
+		draw_text(hdc, part.text.c_str(), hFont, color, part_pos);
+	}
+}
+
+size_t litehtml::text_run::new_id()
+{
+	static std::atomic<size_t> next_id(1);
+	return next_id++;
+}
+
 void litehtml::document_container::split_text(const char* text, const std::function<void(const tchar_t*)>& on_word, const std::function<void(const tchar_t*)>& on_space)
 {
 	std::wstring str;
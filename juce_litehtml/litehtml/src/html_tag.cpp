@@ -14,6 +14,8 @@ JSClassID litehtml::html_tag::jsClassID = 0;
 litehtml::html_tag::html_tag(const std::shared_ptr<litehtml::document>& doc) : litehtml::element(doc)
 {
 	m_box_sizing			= box_sizing_content_box;
+	m_tag					= nullptr;
+	m_id					= nullptr;
 	m_z_index				= 0;
 	m_overflow				= overflow_visible;
 	m_box					= nullptr;
@@ -34,6 +36,8 @@ litehtml::html_tag::html_tag(const std::shared_ptr<litehtml::document>& doc) : l
 	m_border_spacing_x		= 0;
 	m_border_spacing_y		= 0;
 	m_border_collapse		= border_collapse_separate;
+	m_style_shareable		= true;
+	m_shared_style			= nullptr;
 }
 
 void litehtml::html_tag::register_js_prototype(JSContext* ctx, JSValue prototype)
@@ -76,7 +80,7 @@ void litehtml::html_tag::clearRecursive()
 
 const litehtml::tchar_t* litehtml::html_tag::get_tagName() const
 {
-	return m_tag.c_str();
+	return atom_str(m_tag);
 }
 
 void litehtml::html_tag::set_attr( const tchar_t* name, const tchar_t* val )
@@ -88,22 +92,66 @@ void litehtml::html_tag::set_attr( const tchar_t* name, const tchar_t* val )
 		{
 			i = std::tolower(i, std::locale::classic());
 		}
-		m_attrs[s_val] = val;
+		atom_table& atoms = document_ptr()->context()->atoms();
+		atom attr_name = atoms.intern(s_val);
 
-		if( t_strcasecmp( name, _t("class") ) == 0 )
+		auto attr = std::find_if(m_attrs.begin(), m_attrs.end(), [attr_name](const std::pair<atom, tstring>& a) { return a.first == attr_name; });
+		if(attr != m_attrs.end())
 		{
-			m_class_values.resize( 0 );
-			split_string( val, m_class_values, _t(" ") );
+			attr->second = val;
+		} else
+		{
+			m_attrs.emplace_back(attr_name, val);
+		}
+
+		// ids and classes are matched case insensitive
+		if(attr_name == atom_class())
+		{
+			string_vector tokens;
+			split_string( val, tokens, _t(" ") );
+
+			m_class_values.clear();
+			for(auto& token : tokens)
+			{
+				lcase(token);
+				m_class_values.push_back(atoms.intern(token));
+			}
+		} else if(attr_name == atom_id())
+		{
+			tstring id = val;
+			lcase(id);
+			m_id = atoms.intern(id);
 		}
 	}
 }
 
 const litehtml::tchar_t* litehtml::html_tag::get_attr( const tchar_t* name, const tchar_t* def ) const
 {
-	auto attr = m_attrs.find(name);
-	if(attr != m_attrs.end())
+	// the names are compared as strings, so the lookup does not depend on the atoms table
+	if(name)
 	{
-		return attr->second.c_str();
+		for(const auto& attr : m_attrs)
+		{
+			if(*attr.first == name)
+			{
+				return attr.second.c_str();
+			}
+		}
+	}
+	return def;
+}
+
+const litehtml::tchar_t* litehtml::html_tag::get_attr( atom name, const tchar_t* def ) const
+{
+	if(name)
+	{
+		for(const auto& attr : m_attrs)
+		{
+			if(attr.first == name)
+			{
+				return attr.second.c_str();
+			}
+		}
 	}
 	return def;
 }
@@ -111,7 +159,7 @@ const litehtml::tchar_t* litehtml::html_tag::get_attr( const tchar_t* name, cons
 litehtml::elements_vector litehtml::html_tag::select_all( const tstring& selector )
 {
 	css_selector sel(media_query_list::ptr(nullptr), _t(""));
-	sel.parse(selector);
+	sel.parse(selector, document_ptr()->context()->atoms());
 
 	return select_all(sel);
 }
@@ -140,7 +188,7 @@ void litehtml::html_tag::select_all(const css_selector& selector, elements_vecto
 litehtml::element::ptr litehtml::html_tag::select_one( const tstring& selector )
 {
 	css_selector sel(media_query_list::ptr(nullptr), _t(""));
-	sel.parse(selector);
+	sel.parse(selector, document_ptr()->context()->atoms());
 
 	return select_one(sel);
 }
@@ -167,12 +215,87 @@ void litehtml::html_tag::apply_stylesheet( const litehtml::css& stylesheet )
 {
 	remove_before_after();
 
-	for(const auto& sel : stylesheet.selectors())
+	document* doc = document_ptr();
+	ancestor_filter& filter = doc->get_ancestor_filter();
+	style_stats& stats = doc->get_style_stats();
+
+	std::vector<const html_tag*>* siblings = doc->get_style_siblings();
+	doc->set_style_siblings(nullptr);
+
+	// styling a subtree: fill the filter with the ancestors of its root
+	bool filled = false;
+	element* el_parent = parent_ptr();
+	if(filter.top() != el_parent)
 	{
+		filter.clear();
+		std::vector<const element*> ancestors;
+		for(const element* el = el_parent; el; el = el->parent_ptr())
+		{
+			ancestors.push_back(el);
+		}
+		for(auto el = ancestors.rbegin(); el != ancestors.rend(); el++)
+		{
+			(*el)->add_ancestor_keys(filter);
+		}
+		filled = true;
+	}
+
+	// a sibling with the same matching inputs has matched the same rules
+	m_shared_style = nullptr;
+	if(siblings && m_style_shareable)
+	{
+		for(auto sibling = siblings->rbegin(); sibling != siblings->rend(); sibling++)
+		{
+			if(can_share_style(**sibling))
+			{
+				m_shared_style = *sibling;
+				break;
+			}
+		}
+	}
+
+	int_vector candidates;
+	if(m_shared_style)
+	{
+		m_style		= m_shared_style->m_style;
+		m_computed	= m_shared_style->m_computed;
+		m_used_styles.clear();
+		for(const auto& us : m_shared_style->m_used_styles)
+		{
+			m_used_styles.push_back(std::unique_ptr<used_selector>(new used_selector(us->m_selector, us->m_used)));
+		}
+		stats.styles_shared++;
+	} else
+	{
+		stylesheet.get_candidates(m_id, m_class_values, m_tag, candidates);
+	}
+
+	for(int idx : candidates)
+	{
+		const css_selector::ptr& sel = stylesheet.selectors()[idx];
+		stats.selectors_tested++;
+		if(sel->m_sibling_dependent)
+		{
+			m_style_shareable = false;
+		}
+		if(!sel->m_ancestor_keys.empty())
+		{
+			stats.filter_checked++;
+			if(!filter.may_contain_all(sel->m_ancestor_keys))
+			{
+				stats.filter_rejected++;
+				continue;
+			}
+		}
+
 		int apply = select(*sel, false);
 
 		if(apply != select_no_match)
 		{
+			if(apply & (select_match_with_after | select_match_with_before))
+			{
+				m_style_shareable = false;
+			}
 			used_selector::ptr us = std::unique_ptr<used_selector>(new used_selector(sel, false));
 
 			if(sel->is_media_valid())
@@ -226,13 +349,57 @@ void litehtml::html_tag::apply_stylesheet( const litehtml::css& stylesheet )
 		}
 	}
 
+	// var() in the children styles refers to the custom properties declared so far
+	if(!m_shared_style)
+	{
+		compute_style();
+	}
+
+	if(siblings && m_style_shareable)
+	{
+		if(siblings->size() == style_sharing_candidates)
+		{
+			siblings->erase(siblings->begin());
+		}
+		siblings->push_back(this);
+	}
+
+	add_ancestor_keys(filter);
+	std::vector<const html_tag*> styled_children;
 	for(auto& el : m_children)
 	{
 		if(el->get_display() != display_inline_text)
 		{
+			doc->set_style_siblings(&styled_children);
 			el->apply_stylesheet(stylesheet);
 		}
 	}
+	doc->set_style_siblings(nullptr);
+	if(filter.top() == this)
+	{
+		filter.pop();
+	}
+	if(filled)
+	{
+		filter.clear();
+	}
+}
+
+void litehtml::html_tag::add_ancestor_keys( ancestor_filter& filter ) const
+{
+	filter.push(this);
+	if(m_tag)
+	{
+		filter.add(ancestor_filter::key(m_tag, ancestor_filter::key_tag));
+	}
+	if(m_id)
+	{
+		filter.add(ancestor_filter::key(m_id, ancestor_filter::key_id));
+	}
+	for(atom cls : m_class_values)
+	{
+		filter.add(ancestor_filter::key(cls, ancestor_filter::key_class));
+	}
 }
 
 void litehtml::html_tag::get_content_size( size& sz, int max_width )
@@ -289,15 +456,57 @@ litehtml::uint_ptr litehtml::html_tag::get_font(font_metrics* fm)
 	return m_font;
 }
 
+const litehtml::tchar_t* litehtml::html_tag::get_style_property( css_property id, bool inherited, const tchar_t* def /*= 0*/ ) const
+{
+	const tchar_t* ret = m_style.get_property(id);
+	if ( ( ret && !t_strcasecmp(ret, _t("inherit")) ) || (!ret && inherited) )
+	{
+		// no reference counting, this is called for every property lookup
+		const element* el_parent = parent_ptr();
+		if (el_parent)
+		{
+			if(inherited && id < css_inherited_count)
+			{
+				// resolved when the parent styles were parsed
+				const computed_style::ptr& computed = el_parent->get_computed_style();
+				ret = computed ? computed->get_property(id) : nullptr;
+			} else
+			{
+				ret = el_parent->get_style_property(id, inherited, def);
+			}
+		}
+	}
+
+	if(!ret)
+	{
+		ret = def;
+	}
+
+	return ret;
+}
+
 const litehtml::tchar_t* litehtml::html_tag::get_style_property( const tchar_t* name, bool inherited, const tchar_t* def /*= 0*/ ) const
 {
+	css_property id = css_property_id(name);
+	if(id != css_property_unknown)
+	{
+		return get_style_property(id, inherited, def);
+	}
+
 	const tchar_t* ret = m_style.get_property(name);
-	element::ptr el_parent = parent();
-	if (el_parent)
+	if ( ( ret && !t_strcasecmp(ret, _t("inherit")) ) || (!ret && inherited) )
 	{
-		if ( ( ret && !t_strcasecmp(ret, _t("inherit")) ) || (!ret && inherited) )
+		const element* el_parent = parent_ptr();
+		if (el_parent)
 		{
-			ret = el_parent->get_style_property(name, inherited, def);
+			if(inherited && name[0] == _t('-') && name[1] == _t('-'))
+			{
+				const computed_style::ptr& computed = el_parent->get_computed_style();
+				ret = computed ? computed->get_custom_property(name) : nullptr;
+			} else
+			{
+				ret = el_parent->get_style_property(name, inherited, def);
+			}
 		}
 	}
 
@@ -309,6 +518,17 @@ const litehtml::tchar_t* litehtml::html_tag::get_style_property( const tchar_t*
 	return ret;
 }
 
+const litehtml::computed_style::ptr& litehtml::html_tag::get_computed_style() const
+{
+	return m_computed;
+}
+
+void litehtml::html_tag::compute_style()
+{
+	const element* el_parent = parent_ptr();
+	m_computed = m_style.compute(el_parent ? el_parent->get_computed_style() : computed_style::ptr());
+}
+
 void litehtml::html_tag::parse_styles(bool is_reparse)
 {
 	const tchar_t* style = get_attr(_t("style"));
@@ -318,33 +538,98 @@ void litehtml::html_tag::parse_styles(bool is_reparse)
 		m_style.add(style, nullptr, this);
 	}
 
+	// a sibling sharing the style has parsed the same declarations with the same parent
+	if(m_shared_style && !is_reparse)
+	{
+		m_computed = m_shared_style->m_computed;
+		copy_style_fields(*m_shared_style);
+	} else
+	{
+		// the children read the inherited values from here
+		compute_style();
+		parse_style_fields();
+	}
+	m_shared_style = nullptr;
+
+	document::ptr doc = get_document();
+
+	if (m_display == display_table ||
+		m_display == display_inline_table ||
+		m_display == display_table_caption ||
+		m_display == display_table_cell ||
+		m_display == display_table_column ||
+		m_display == display_table_column_group ||
+		m_display == display_table_footer_group ||
+		m_display == display_table_header_group ||
+		m_display == display_table_row ||
+		m_display == display_table_row_group)
+	{
+		doc->add_tabular(shared_from_this());
+	}
+
+	if(!is_reparse)
+	{
+		// the words of the text children share the font and get measured by one call
+		std::vector<std::pair<element*, size_t>> words;
+		std::vector<const tchar_t*> texts;
+
+		for(auto& el : m_children)
+		{
+			size_t first = texts.size();
+			if(el->parse_text_styles(texts))
+			{
+				if(texts.size() > first)
+				{
+					words.emplace_back(el.get(), first);
+				}
+			} else
+			{
+				el->parse_styles();
+			}
+		}
+
+		if(!texts.empty())
+		{
+			std::vector<int> widths(texts.size(), 0);
+			doc->container()->text_widths(texts.data(), texts.size(), m_font, widths.data());
+
+			for(const auto& word : words)
+			{
+				word.first->set_text_widths(widths.data() + word.second);
+			}
+		}
+	}
+}
+
+void litehtml::html_tag::parse_style_fields()
+{
 	init_font();
 	document::ptr doc = get_document();
 
-	m_el_position	= (element_position)	value_index(get_style_property(_t("position"),		false,	_t("static")),		element_position_strings,	element_position_fixed);
-	m_text_align	= (text_align)			value_index(get_style_property(_t("text-align"),	true,	_t("left")),		text_align_strings,			text_align_left);
-	m_overflow		= (overflow)			value_index(get_style_property(_t("overflow"),		false,	_t("visible")),		overflow_strings,			overflow_visible);
-	m_white_space	= (white_space)			value_index(get_style_property(_t("white-space"),	true,	_t("normal")),		white_space_strings,		white_space_normal);
-	m_display		= (style_display)		value_index(get_style_property(_t("display"),		false,	_t("inline")),		style_display_strings,		display_inline);
-	m_visibility	= (visibility)			value_index(get_style_property(_t("visibility"),	true,	_t("visible")),		visibility_strings,			visibility_visible);
-	m_box_sizing	= (box_sizing)			value_index(get_style_property(_t("box-sizing"),	false,	_t("content-box")),	box_sizing_strings,			box_sizing_content_box);
+	m_el_position	= (element_position)	value_index(get_style_property(css_property_position,		false,	_t("static")),		element_position_keywords,	element_position_fixed);
+	m_text_align	= (text_align)			value_index(get_style_property(css_property_text_align,	true,	_t("left")),		text_align_keywords,			text_align_left);
+	m_overflow		= (overflow)			value_index(get_style_property(css_property_overflow,		false,	_t("visible")),		overflow_keywords,			overflow_visible);
+	m_white_space	= (white_space)			value_index(get_style_property(css_property_white_space,	true,	_t("normal")),		white_space_keywords,		white_space_normal);
+	m_display		= (style_display)		value_index(get_style_property(css_property_display,		false,	_t("inline")),		style_display_keywords,		display_inline);
+	m_visibility	= (visibility)			value_index(get_style_property(css_property_visibility,	true,	_t("visible")),		visibility_keywords,			visibility_visible);
+	m_box_sizing	= (box_sizing)			value_index(get_style_property(css_property_box_sizing,	false,	_t("content-box")),	box_sizing_keywords,			box_sizing_content_box);
 
 	if(m_el_position != element_position_static)
 	{
-		const tchar_t* val = get_style_property(_t("z-index"), false, nullptr);
+		const tchar_t* val = get_style_property(css_property_z_index, false, nullptr);
 		if(val)
 		{
 			m_z_index = t_atoi(val);
 		}
 	}
 
-	const tchar_t* va	= get_style_property(_t("vertical-align"), true,	_t("baseline"));
-	m_vertical_align = (vertical_align) value_index(va, vertical_align_strings, va_baseline);
+	const tchar_t* va	= get_style_property(css_property_vertical_align, true,	_t("baseline"));
+	m_vertical_align = (vertical_align) value_index(va, vertical_align_keywords, va_baseline);
 
-	const tchar_t* fl	= get_style_property(_t("float"), false,	_t("none"));
-	m_float = (element_float) value_index(fl, element_float_strings, float_none);
+	const tchar_t* fl	= get_style_property(css_property_float, false,	_t("none"));
+	m_float = (element_float) value_index(fl, element_float_keywords, float_none);
 
-	m_clear = (element_clear) value_index(get_style_property(_t("clear"), false, _t("none")), element_clear_strings, clear_none);
+	m_clear = (element_clear) value_index(get_style_property(css_property_clear, false, _t("none")), element_clear_keywords, clear_none);
 
 	if (m_display != display_none &&
 		m_display != display_table &&
@@ -362,85 +647,71 @@ void litehtml::html_tag::parse_styles(bool is_reparse)
 		}
 	}
 
-	if (m_display == display_table ||
-		m_display == display_inline_table ||
-		m_display == display_table_caption ||
-		m_display == display_table_cell ||
-		m_display == display_table_column ||
-		m_display == display_table_column_group ||
-		m_display == display_table_footer_group ||
-		m_display == display_table_header_group ||
-		m_display == display_table_row ||
-		m_display == display_table_row_group)
-	{
-		doc->add_tabular(shared_from_this());
-	}
-
-	m_css_text_indent.fromString(	get_style_property(_t("text-indent"),	true,	_t("0")),	_t("0"));
+	m_css_text_indent.fromString(	get_style_property(css_property_text_indent,	true,	_t("0")),	_t("0"));
 
-	m_css_width.fromString(			get_style_property(_t("width"),			false,	_t("auto")), _t("auto"));
-	m_css_height.fromString(		get_style_property(_t("height"),		false,	_t("auto")), _t("auto"));
+	m_css_width.fromString(			get_style_property(css_property_width,			false,	_t("auto")), _t("auto"));
+	m_css_height.fromString(		get_style_property(css_property_height,		false,	_t("auto")), _t("auto"));
 
 	doc->cvt_units(m_css_width, m_font_size);
 	doc->cvt_units(m_css_height, m_font_size);
 
-	m_css_min_width.fromString(		get_style_property(_t("min-width"),		false,	_t("0")));
-	m_css_min_height.fromString(	get_style_property(_t("min-height"),	false,	_t("0")));
+	m_css_min_width.fromString(		get_style_property(css_property_min_width,		false,	_t("0")));
+	m_css_min_height.fromString(	get_style_property(css_property_min_height,	false,	_t("0")));
 
-	m_css_max_width.fromString(		get_style_property(_t("max-width"),		false,	_t("none")),	_t("none"));
-	m_css_max_height.fromString(	get_style_property(_t("max-height"),	false,	_t("none")),	_t("none"));
+	m_css_max_width.fromString(		get_style_property(css_property_max_width,		false,	_t("none")),	_t("none"));
+	m_css_max_height.fromString(	get_style_property(css_property_max_height,	false,	_t("none")),	_t("none"));
 
 	doc->cvt_units(m_css_min_width, m_font_size);
 	doc->cvt_units(m_css_min_height, m_font_size);
 
-	m_css_offsets.left.fromString(		get_style_property(_t("left"),				false,	_t("auto")), _t("auto"));
-	m_css_offsets.right.fromString(		get_style_property(_t("right"),				false,	_t("auto")), _t("auto"));
-	m_css_offsets.top.fromString(		get_style_property(_t("top"),				false,	_t("auto")), _t("auto"));
-	m_css_offsets.bottom.fromString(	get_style_property(_t("bottom"),			false,	_t("auto")), _t("auto"));
+	m_css_offsets.left.fromString(		get_style_property(css_property_left,				false,	_t("auto")), _t("auto"));
+	m_css_offsets.right.fromString(		get_style_property(css_property_right,				false,	_t("auto")), _t("auto"));
+	m_css_offsets.top.fromString(		get_style_property(css_property_top,				false,	_t("auto")), _t("auto"));
+	m_css_offsets.bottom.fromString(	get_style_property(css_property_bottom,			false,	_t("auto")), _t("auto"));
 
 	doc->cvt_units(m_css_offsets.left,		m_font_size);
 	doc->cvt_units(m_css_offsets.right,		m_font_size);
 	doc->cvt_units(m_css_offsets.top,		m_font_size);
 	doc->cvt_units(m_css_offsets.bottom,	m_font_size);
 
-	m_css_margins.left.fromString(		get_style_property(_t("margin-left"),		false,	_t("0")), _t("auto"));
-	m_css_margins.right.fromString(		get_style_property(_t("margin-right"),		false,	_t("0")), _t("auto"));
-	m_css_margins.top.fromString(		get_style_property(_t("margin-top"),		false,	_t("0")), _t("auto"));
-	m_css_margins.bottom.fromString(	get_style_property(_t("margin-bottom"),		false,	_t("0")), _t("auto"));
+	m_css_margins.left.fromString(		get_style_property(css_property_margin_left,		false,	_t("0")), _t("auto"));
+	m_css_margins.right.fromString(		get_style_property(css_property_margin_right,		false,	_t("0")), _t("auto"));
+	m_css_margins.top.fromString(		get_style_property(css_property_margin_top,		false,	_t("0")), _t("auto"));
+	m_css_margins.bottom.fromString(	get_style_property(css_property_margin_bottom,		false,	_t("0")), _t("auto"));
 
-	m_css_padding.left.fromString(		get_style_property(_t("padding-left"),		false,	_t("0")), _t(""));
-	m_css_padding.right.fromString(		get_style_property(_t("padding-right"),		false,	_t("0")), _t(""));
-	m_css_padding.top.fromString(		get_style_property(_t("padding-top"),		false,	_t("0")), _t(""));
-	m_css_padding.bottom.fromString(	get_style_property(_t("padding-bottom"),	false,	_t("0")), _t(""));
+	m_css_padding.left.fromString(		get_style_property(css_property_padding_left,		false,	_t("0")), _t(""));
+	m_css_padding.right.fromString(		get_style_property(css_property_padding_right,		false,	_t("0")), _t(""));
+	m_css_padding.top.fromString(		get_style_property(css_property_padding_top,		false,	_t("0")), _t(""));
+	m_css_padding.bottom.fromString(	get_style_property(css_property_padding_bottom,	false,	_t("0")), _t(""));
 
-	m_css_borders.left.width.fromString(	get_style_property(_t("border-left-width"),		false,	_t("medium")), border_width_strings);
-	m_css_borders.right.width.fromString(	get_style_property(_t("border-right-width"),	false,	_t("medium")), border_width_strings);
-	m_css_borders.top.width.fromString(		get_style_property(_t("border-top-width"),		false,	_t("medium")), border_width_strings);
-	m_css_borders.bottom.width.fromString(	get_style_property(_t("border-bottom-width"),	false,	_t("medium")), border_width_strings);
+	m_css_borders.left.width.fromString(	get_style_property(css_property_border_left_width,		false,	_t("medium")), border_width_strings);
+	m_css_borders.right.width.fromString(	get_style_property(css_property_border_right_width,	false,	_t("medium")), border_width_strings);
+	m_css_borders.top.width.fromString(		get_style_property(css_property_border_top_width,		false,	_t("medium")), border_width_strings);
+	m_css_borders.bottom.width.fromString(	get_style_property(css_property_border_bottom_width,	false,	_t("medium")), border_width_strings);
 
-	m_css_borders.left.color = web_color::from_string(get_style_property(_t("border-left-color"),	false,	_t("")), doc->container());
-	m_css_borders.left.style = (border_style) value_index(get_style_property(_t("border-left-style"), false, _t("none")), border_style_strings, border_style_none);
+	m_css_borders.left.color = web_color::from_string(get_style_property(css_property_border_left_color,	false,	_t("")), doc->container());
+	m_css_borders.left.style = (border_style) value_index(get_style_property(css_property_border_left_style, false, _t("none")), border_style_keywords, border_style_none);
 
-    m_css_borders.right.color = web_color::from_string(get_style_property(_t("border-right-color"), false, _t("")), doc->container());
-	m_css_borders.right.style = (border_style) value_index(get_style_property(_t("border-right-style"), false, _t("none")), border_style_strings, border_style_none);
+    m_css_borders.right.color = web_color::from_string(get_style_property(css_property_border_right_color, false, _t("")), doc->container());
+	m_css_borders.right.style = (border_style) value_index(get_style_property(css_property_border_right_style, false, _t("none")), border_style_keywords, border_style_none);
 
-    m_css_borders.top.color = web_color::from_string(get_style_property(_t("border-top-color"), false, _t("")), doc->container());
-	m_css_borders.top.style = (border_style) value_index(get_style_property(_t("border-top-style"), false, _t("none")), border_style_strings, border_style_none);
+    m_css_borders.top.color = web_color::from_string(get_style_property(css_property_border_top_color, false, _t("")), doc->container());
+	m_css_borders.top.style = (border_style) value_index(get_style_property(css_property_border_top_style, false, _t("none")), border_style_keywords, border_style_none);
 
-    m_css_borders.bottom.color = web_color::from_string(get_style_property(_t("border-bottom-color"), false, _t("")), doc->container());
-	m_css_borders.bottom.style = (border_style) value_index(get_style_property(_t("border-bottom-style"), false, _t("none")), border_style_strings, border_style_none);
+    m_css_borders.bottom.color = web_color::from_string(get_style_property(css_property_border_bottom_color, false, _t("")), doc->container());
+	m_css_borders.bottom.style = (border_style) value_index(get_style_property(css_property_border_bottom_style, false, _t("none")), border_style_keywords, border_style_none);
 
-	m_css_borders.radius.top_left_x.fromString(get_style_property(_t("border-top-left-radius-x"), false, _t("0")));
-	m_css_borders.radius.top_left_y.fromString(get_style_property(_t("border-top-left-radius-y"), false, _t("0")));
+	m_css_borders.radius.top_left_x.fromString(get_style_property(css_property_border_top_left_radius_x, false, _t("0")));
+	m_css_borders.radius.top_left_y.fromString(get_style_property(css_property_border_top_left_radius_y, false, _t("0")));
 
-	m_css_borders.radius.top_right_x.fromString(get_style_property(_t("border-top-right-radius-x"), false, _t("0")));
-	m_css_borders.radius.top_right_y.fromString(get_style_property(_t("border-top-right-radius-y"), false, _t("0")));
+	m_css_borders.radius.top_right_x.fromString(get_style_property(css_property_border_top_right_radius_x, false, _t("0")));
+	m_css_borders.radius.top_right_y.fromString(get_style_property(css_property_border_top_right_radius_y, false, _t("0")));
 
-	m_css_borders.radius.bottom_right_x.fromString(get_style_property(_t("border-bottom-right-radius-x"), false, _t("0")));
-	m_css_borders.radius.bottom_right_y.fromString(get_style_property(_t("border-bottom-right-radius-y"), false, _t("0")));
+	m_css_borders.radius.bottom_right_x.fromString(get_style_property(css_property_border_bottom_right_radius_x, false, _t("0")));
+	m_css_borders.radius.bottom_right_y.fromString(get_style_property(css_property_border_bottom_right_radius_y, false, _t("0")));
 
-	m_css_borders.radius.bottom_left_x.fromString(get_style_property(_t("border-bottom-left-radius-x"), false, _t("0")));
-	m_css_borders.radius.bottom_left_y.fromString(get_style_property(_t("border-bottom-left-radius-y"), false, _t("0")));
+	m_css_borders.radius.bottom_left_x.fromString(get_style_property(css_property_border_bottom_left_radius_x, false, _t("0")));
+	m_css_borders.radius.bottom_left_y.fromString(get_style_property(css_property_border_bottom_left_radius_y, false, _t("0")));
 
 	doc->cvt_units(m_css_borders.radius.bottom_left_x,			m_font_size);
 	doc->cvt_units(m_css_borders.radius.bottom_left_y,			m_font_size);
@@ -469,7 +740,7 @@ void litehtml::html_tag::parse_styles(bool is_reparse)
 	m_borders.bottom	= doc->cvt_units(m_css_borders.bottom.width,	m_font_size);
 
 	css_length line_height;
-	line_height.fromString(get_style_property(_t("line-height"),	true,	_t("normal")), _t("normal"));
+	line_height.fromString(get_style_property(css_property_line_height,	true,	_t("normal")), _t("normal"));
 	if(line_height.is_predefined())
 	{
 		m_line_height = m_font_metrics.height;
@@ -487,33 +758,77 @@ void litehtml::html_tag::parse_styles(bool is_reparse)
 
 	if(m_display == display_list_item)
 	{
-		const tchar_t* list_type = get_style_property(_t("list-style-type"), true, _t("disc"));
-		m_list_style_type = (list_style_type) value_index(list_type, list_style_type_strings, list_style_type_disc);
+		const tchar_t* list_type = get_style_property(css_property_list_style_type, true, _t("disc"));
+		m_list_style_type = (list_style_type) value_index(list_type, list_style_type_keywords, list_style_type_disc);
 
-		const tchar_t* list_pos = get_style_property(_t("list-style-position"), true, _t("outside"));
-		m_list_style_position = (list_style_position) value_index(list_pos, list_style_position_strings, list_style_position_outside);
+		const tchar_t* list_pos = get_style_property(css_property_list_style_position, true, _t("outside"));
+		m_list_style_position = (list_style_position) value_index(list_pos, list_style_position_keywords, list_style_position_outside);
 
-		const tchar_t* list_image = get_style_property(_t("list-style-image"), true, nullptr);
+		const tchar_t* list_image = get_style_property(css_property_list_style_image, true, nullptr);
 		if(list_image && list_image[0])
 		{
 			tstring url;
 			css::parse_css_url(list_image, url);
 
-			const tchar_t* list_image_baseurl = get_style_property(_t("list-style-image-baseurl"), true, nullptr);
+			const tchar_t* list_image_baseurl = get_style_property(css_property_list_style_image_baseurl, true, nullptr);
 			doc->container()->load_image(url.c_str(), list_image_baseurl, true);
 		}
 
 	}
 
 	parse_background();
+}
 
-	if(!is_reparse)
-	{
-		for(auto& el : m_children)
-		{
-			el->parse_styles();
-		}
-	}
+void litehtml::html_tag::copy_style_fields(const html_tag& src)
+{
+	m_font					= src.m_font;
+	m_font_size				= src.m_font_size;
+	m_font_metrics			= src.m_font_metrics;
+
+	m_el_position			= src.m_el_position;
+	m_text_align			= src.m_text_align;
+	m_overflow				= src.m_overflow;
+	m_white_space			= src.m_white_space;
+	m_display				= src.m_display;
+	m_visibility			= src.m_visibility;
+	m_box_sizing			= src.m_box_sizing;
+	m_z_index				= src.m_z_index;
+	m_vertical_align		= src.m_vertical_align;
+	m_float					= src.m_float;
+	m_clear					= src.m_clear;
+
+	m_css_text_indent		= src.m_css_text_indent;
+	m_css_width				= src.m_css_width;
+	m_css_height			= src.m_css_height;
+	m_css_min_width			= src.m_css_min_width;
+	m_css_min_height		= src.m_css_min_height;
+	m_css_max_width			= src.m_css_max_width;
+	m_css_max_height		= src.m_css_max_height;
+	m_css_offsets			= src.m_css_offsets;
+	m_css_margins			= src.m_css_margins;
+	m_css_padding			= src.m_css_padding;
+	m_css_borders			= src.m_css_borders;
+
+	m_margins				= src.m_margins;
+	m_padding				= src.m_padding;
+	m_borders				= src.m_borders;
+
+	m_line_height			= src.m_line_height;
+	m_lh_predefined			= src.m_lh_predefined;
+	m_list_style_type		= src.m_list_style_type;
+	m_list_style_position	= src.m_list_style_position;
+	m_bg					= src.m_bg;
+}
+
+bool litehtml::html_tag::can_share_style(const html_tag& sibling) const
+{
+	// the rules for an id can't match a sibling
+	return	sibling.m_style_shareable &&
+			!m_id && !sibling.m_id &&
+			m_tag == sibling.m_tag &&
+			m_class_values == sibling.m_class_values &&
+			m_pseudo_classes == sibling.m_pseudo_classes &&
+			m_attrs == sibling.m_attrs;
 }
 
 int litehtml::html_tag::render( int x, int y, int max_width, bool second_pass )
@@ -609,7 +924,7 @@ int litehtml::html_tag::select(const css_selector& selector, bool apply_pseudo)
 	{
 		return select_no_match;
 	}
-	element::ptr el_parent = parent();
+	element* el_parent = parent_ptr();
 	if(selector.m_left)
 	{
 		if (!el_parent)
@@ -690,12 +1005,9 @@ int litehtml::html_tag::select(const css_selector& selector, bool apply_pseudo)
 
 int litehtml::html_tag::select(const css_element_selector& selector, bool apply_pseudo)
 {
-	if(!selector.m_tag.empty() && selector.m_tag != _t("*"))
+	if(selector.m_tag && selector.m_tag != m_tag)
 	{
-		if(selector.m_tag != m_tag)
-		{
-			return select_no_match;
-		}
+		return select_no_match;
 	}
 
 	int res = select_match;
@@ -703,7 +1015,31 @@ int litehtml::html_tag::select(const css_element_selector& selector, bool apply_
 
 	for(const auto& attr : selector.m_attrs)
 	{
-		const tchar_t* attr_value = get_attr(attr.attribute.c_str());
+		// the ids and classes are compared as atoms
+		if(attr.condition == select_equal)
+		{
+			if(attr.attribute == atom_class())
+			{
+				for(atom cls : attr.class_val)
+				{
+					if(std::find(m_class_values.begin(), m_class_values.end(), cls) == m_class_values.end())
+					{
+						return select_no_match;
+					}
+				}
+				continue;
+			}
+			if(attr.attribute == atom_id())
+			{
+				if(!m_id || m_id != attr.val_atom)
+				{
+					return select_no_match;
+				}
+				continue;
+			}
+		}
+
+		const tchar_t* attr_value = get_attr(attr.attribute);
 		switch(attr.condition)
 		{
 		case select_exists:
@@ -713,42 +1049,9 @@ int litehtml::html_tag::select(const css_element_selector& selector, bool apply_
 			}
 			break;
 		case select_equal:
-			if(!attr_value)
+			if(!attr_value || t_strcasecmp(attr.val.c_str(), attr_value))
 			{
 				return select_no_match;
-			} else
-			{
-				if(attr.attribute == _t("class"))
-				{
-					const string_vector & tokens1 = m_class_values;
-					const string_vector & tokens2 = attr.class_val;
-					bool found = true;
-					for(const auto& str1 : tokens2)
-					{
-						bool f = false;
-						for(const auto& str2 : tokens1)
-						{
-							if( !t_strcasecmp(str1.c_str(), str2.c_str()) )
-							{
-								f = true;
-							}
-						}
-						if(!f)
-						{
-							found = false;
-						}
-					}
-					if(!found)
-					{
-						return select_no_match;
-					}
-				} else
-				{
-					if( t_strcasecmp(attr.val.c_str(), attr_value) )
-					{
-						return select_no_match;
-					}
-				}
 			}
 			break;
 		case select_contain_str:
@@ -813,7 +1116,7 @@ int litehtml::html_tag::select(const css_element_selector& selector, bool apply_
 					selector_name = attr.val;
 				}
 
-				int pseudo_selector = value_index(selector_name, pseudo_class_strings);
+				int pseudo_selector = value_index(selector_name, pseudo_class_keywords);
 
 				switch(pseudo_selector)
 				{
@@ -898,7 +1201,7 @@ int litehtml::html_tag::select(const css_element_selector& selector, bool apply_
 				case pseudo_class_not:
 					{
 						css_element_selector sel;
-						sel.parse(selector_param);
+						sel.parse(selector_param, document_ptr()->context()->atoms());
 						if(select(sel, apply_pseudo))
 						{
 							return select_no_match;
@@ -934,7 +1237,7 @@ int litehtml::html_tag::select(const css_element_selector& selector, bool apply_
 
 litehtml::element::ptr litehtml::html_tag::find_ancestor(const css_selector& selector, bool apply_pseudo, bool* is_pseudo)
 {
-	element::ptr el_parent = parent();
+	element* el_parent = parent_ptr();
 	if (!el_parent)
 	{
 		return nullptr;
@@ -952,7 +1255,7 @@ litehtml::element::ptr litehtml::html_tag::find_ancestor(const css_selector& sel
 				*is_pseudo = false;
 			}
 		}
-		return el_parent;
+		return el_parent->shared_from_this();
 	}
 	return el_parent->find_ancestor(selector, apply_pseudo, is_pseudo);
 }
@@ -1435,10 +1738,10 @@ int litehtml::html_tag::find_next_line_top( int top, int width, int def_right )
 void litehtml::html_tag::parse_background()
 {
 	// parse background-color
-	m_bg.m_color		= get_color(_t("background-color"), false, web_color(0, 0, 0, 0));
+	m_bg.m_color		= get_color(css_property_background_color, false, web_color(0, 0, 0, 0));
 
 	// parse background-position
-	const tchar_t* str = get_style_property(_t("background-position"), false, _t("0% 0%"));
+	const tchar_t* str = get_style_property(css_property_background_position, false, _t("0% 0%"));
 	if(str)
 	{
 		string_vector res;
@@ -1526,7 +1829,7 @@ void litehtml::html_tag::parse_background()
 		m_bg.m_position.x.set_value(0, css_units_percentage);
 	}
 
-	str = get_style_property(_t("background-size"), false, _t("auto"));
+	str = get_style_property(css_property_background_size, false, _t("auto"));
 	if(str)
 	{
 		string_vector res;
@@ -1557,34 +1860,36 @@ void litehtml::html_tag::parse_background()
 
 	// parse background_attachment
 	m_bg.m_attachment = (background_attachment) value_index(
-		get_style_property(_t("background-attachment"), false, _t("scroll")),
-		background_attachment_strings,
+		get_style_property(css_property_background_attachment, false, _t("scroll")),
+		background_attachment_keywords,
 		background_attachment_scroll);
 
 	// parse background_attachment
 	m_bg.m_repeat = (background_repeat) value_index(
-		get_style_property(_t("background-repeat"), false, _t("repeat")),
-		background_repeat_strings,
+		get_style_property(css_property_background_repeat, false, _t("repeat")),
+		background_repeat_keywords,
 		background_repeat_repeat);
 
 	// parse background_clip
 	m_bg.m_clip = (background_box) value_index(
-		get_style_property(_t("background-clip"), false, _t("border-box")),
-		background_box_strings,
+		get_style_property(css_property_background_clip, false, _t("border-box")),
+		background_box_keywords,
 		background_box_border);
 
 	// parse background_origin
 	m_bg.m_origin = (background_box) value_index(
-		get_style_property(_t("background-origin"), false, _t("padding-box")),
-		background_box_strings,
+		get_style_property(css_property_background_origin, false, _t("padding-box")),
+		background_box_keywords,
 		background_box_content);
 
 	// parse background-image
-	css::parse_css_url(get_style_property(_t("background-image"), false, _t("")), m_bg.m_image);
-	m_bg.m_baseurl = get_style_property(_t("background-image-baseurl"), false, _t(""));
+	css::parse_css_url(get_style_property(css_property_background_image, false, _t("")), m_bg.m_image);
+	m_bg.m_baseurl = get_style_property(css_property_background_image_baseurl, false, _t(""));
 
+	m_bg.m_image_handle = 0;
 	if(!m_bg.m_image.empty())
 	{
+		m_bg.m_image_handle = doc->container()->resolve_image(m_bg.m_image.c_str(), m_bg.m_baseurl.empty() ? nullptr : m_bg.m_baseurl.c_str());
 		doc->container()->load_image(m_bg.m_image.c_str(), m_bg.m_baseurl.empty() ? nullptr : m_bg.m_baseurl.c_str(), true);
 	}
 }
@@ -1687,31 +1992,48 @@ void litehtml::html_tag::get_inline_boxes( position::vector& boxes )
 {
 	litehtml::box* old_box = nullptr;
 	position pos;
+
+	auto add_line_item = [&](const element::ptr& el)
+	{
+		if(el->m_box != old_box)
+		{
+			if(old_box)
+			{
+				if(boxes.empty())
+				{
+					pos.x		-= m_padding.left + m_borders.left;
+					pos.width	+= m_padding.left + m_borders.left;
+				}
+				boxes.push_back(pos);
+			}
+			old_box		= el->m_box;
+			pos.x		= el->left() + el->margin_left();
+			pos.y		= el->top() - m_padding.top - m_borders.top;
+			pos.width	= 0;
+			pos.height	= 0;
+		}
+		pos.width	= el->right() - pos.x - el->margin_right() - el->margin_left();
+		pos.height	= std::max(pos.height, el->height() + m_padding.top + m_padding.bottom + m_borders.top + m_borders.bottom);
+	};
+
 	for(auto& el : m_children)
 	{
 		if(!el->skip())
 		{
-			if(el->m_box)
+			if(el->is_text_run())
 			{
-				if(el->m_box != old_box)
+				// the words of a text run are placed as fragments
+				for(size_t i = 0; i < el->get_fragments_count(); i++)
 				{
-					if(old_box)
+					element::ptr fragment = el->get_fragment(i);
+					if(!fragment->skip() && fragment->m_box)
 					{
-						if(boxes.empty())
-						{
-							pos.x		-= m_padding.left + m_borders.left;
-							pos.width	+= m_padding.left + m_borders.left;
-						}
-						boxes.push_back(pos);
+						add_line_item(fragment);
 					}
-					old_box		= el->m_box;
-					pos.x		= el->left() + el->margin_left();
-					pos.y		= el->top() - m_padding.top - m_borders.top;
-					pos.width	= 0;
-					pos.height	= 0;
 				}
-				pos.width	= el->right() - pos.x - el->margin_right() - el->margin_left();
-				pos.height	= std::max(pos.height, el->height() + m_padding.top + m_padding.bottom + m_borders.top + m_borders.bottom);
+			} else if(el->m_box)
+			{
+				add_line_item(el);
 			} else if(el->get_display() == display_inline)
 			{
 				position::vector sub_boxes;
@@ -1916,7 +2238,7 @@ void litehtml::html_tag::on_click()
 
 const litehtml::tchar_t* litehtml::html_tag::get_cursor()
 {
-	return get_style_property(_t("cursor"), true, nullptr);
+	return get_style_property(css_property_cursor, true, nullptr);
 }
 
 static const int font_size_table[8][7] =
@@ -1935,7 +2257,7 @@ static const int font_size_table[8][7] =
 void litehtml::html_tag::init_font()
 {
 	// initialize font size
-	const tchar_t* str = get_style_property(_t("font-size"), false, nullptr);
+	const tchar_t* str = get_style_property(css_property_font_size, false, nullptr);
 
 	int parent_sz = 0;
 	int doc_font_size = get_document()->container()->get_default_font_size();
@@ -2013,10 +2335,10 @@ void litehtml::html_tag::init_font()
 	}
 
 	// initialize font
-	const tchar_t* name			= get_style_property(_t("font-family"),		true,	_t("inherit"));
-	const tchar_t* weight		= get_style_property(_t("font-weight"),		true,	_t("normal"));
-	const tchar_t* style		= get_style_property(_t("font-style"),		true,	_t("normal"));
-	const tchar_t* decoration	= get_style_property(_t("text-decoration"),	true,	_t("none"));
+	const tchar_t* name			= get_style_property(css_property_font_family,		true,	_t("inherit"));
+	const tchar_t* weight		= get_style_property(css_property_font_weight,		true,	_t("normal"));
+	const tchar_t* style		= get_style_property(css_property_font_style,		true,	_t("normal"));
+	const tchar_t* decoration	= get_style_property(css_property_text_decoration,	true,	_t("none"));
 
 	m_font = get_document()->get_font(name, m_font_size, weight, style, decoration, &m_font_metrics);
 }
@@ -2028,11 +2350,12 @@ bool litehtml::html_tag::is_break() const
 
 void litehtml::html_tag::set_tagName( const tchar_t* tag )
 {
-	m_tag = tag;
-	for (tchar_t& i : m_tag)
+	tstring s_tag = tag;
+	for (tchar_t& i : s_tag)
 	{
 		i = std::tolower(i, std::locale::classic());
 	}
+	m_tag = document_ptr()->context()->atoms().intern(s_tag);
 }
 
 void litehtml::html_tag::draw_background( uint_ptr hdc, int x, int y, const position* clip )
@@ -2200,7 +2523,7 @@ int litehtml::html_tag::place_element(const element::ptr &el, int max_width)
 {
 	if(el->get_display() == display_none) return 0;
 
-	if(el->get_display() == display_inline)
+	if(el->get_display() == display_inline || el->is_text_run())
 	{
 		return el->render_inline(shared_from_this(), max_width);
 	}
@@ -2469,17 +2792,19 @@ bool litehtml::html_tag::set_pseudo_class( const tchar_t* pclass, bool add )
 bool litehtml::html_tag::set_class( const tchar_t* pclass, bool add )
 {
 	string_vector classes;
+	string_vector class_values;
 	bool changed = false;
 
 	split_string( pclass, classes, _t(" ") );
+	split_string( get_attr(atom_class(), _t("")), class_values, _t(" ") );
 
 	if(add)
 	{
 		for( auto & _class : classes  )
 		{
-			if(std::find(m_class_values.begin(), m_class_values.end(), _class) == m_class_values.end())
+			if(std::find(class_values.begin(), class_values.end(), _class) == class_values.end())
 			{
-				m_class_values.push_back( std::move( _class ) );
+				class_values.push_back( std::move( _class ) );
 				changed = true;
 			}
 		}
@@ -2487,11 +2812,11 @@ bool litehtml::html_tag::set_class( const tchar_t* pclass, bool add )
 	{
 		for( const auto & _class : classes )
 		{
-			auto end = std::remove(m_class_values.begin(), m_class_values.end(), _class);
+			auto end = std::remove(class_values.begin(), class_values.end(), _class);
 
-			if(end != m_class_values.end())
+			if(end != class_values.end())
 			{
-				m_class_values.erase(end, m_class_values.end());
+				class_values.erase(end, class_values.end());
 				changed = true;
 			}
 		}
@@ -2500,7 +2825,7 @@ bool litehtml::html_tag::set_class( const tchar_t* pclass, bool add )
 	if( changed )
 	{
 		tstring class_string;
-		join_string(class_string, m_class_values, _t(" "));
+		join_string(class_string, class_values, _t(" "));
 		set_attr(_t("class"), class_string.c_str());
 
 		return true;
@@ -2682,7 +3007,7 @@ bool litehtml::html_tag::is_first_child_inline(const element::ptr& el) const
 		{
 			if (!this_el->is_white_space())
 			{
-				if (el == this_el)
+				if (el == this_el || el->is_first_fragment(this_el.get()))
 				{
 					return true;
 				}
@@ -2710,7 +3035,7 @@ bool litehtml::html_tag::is_last_child_inline(const element::ptr& el)
 		{
 			if (!(*this_el)->is_white_space())
 			{
-				if (el == (*this_el))
+				if (el == (*this_el) || el->is_last_fragment(this_el->get()))
 				{
 					return true;
 				}
@@ -2877,7 +3202,7 @@ void litehtml::html_tag::init_background_paint(position pos, background_paint &b
 
 	if(!bg_paint.image.empty())
 	{
-		get_document()->container()->get_image_size(bg_paint.image.c_str(), bg_paint.baseurl.c_str(), bg_paint.image_size);
+		get_document()->get_image_size(bg_paint.image_handle, bg_paint.image.c_str(), bg_paint.baseurl.c_str(), bg_paint.image_size);
 		if(bg_paint.image_size.width && bg_paint.image_size.height)
 		{
 			litehtml::size img_new_sz = bg_paint.image_size;
@@ -2952,12 +3277,12 @@ void litehtml::html_tag::draw_list_marker( uint_ptr hdc, const position &pos )
 {
 	list_marker lm;
 
-	const tchar_t* list_image = get_style_property(_t("list-style-image"), true, nullptr);
+	const tchar_t* list_image = get_style_property(css_property_list_style_image, true, nullptr);
 	size img_size;
 	if(list_image)
 	{
 		css::parse_css_url(list_image, lm.image);
-		lm.baseurl = get_style_property(_t("list-style-image-baseurl"), true, nullptr);
+		lm.baseurl = get_style_property(css_property_list_style_image_baseurl, true, nullptr);
 		get_document()->container()->get_image_size(lm.image.c_str(), lm.baseurl, img_size);
 	} else
 	{
@@ -2968,7 +3293,7 @@ void litehtml::html_tag::draw_list_marker( uint_ptr hdc, const position &pos )
 	int sz_font		= get_font_size();
 	lm.pos.x		= pos.x;
 	lm.pos.width = sz_font - sz_font * 2 / 3;
-	lm.color = get_color(_t("color"), true, web_color(0, 0, 0));
+	lm.color = get_color(css_property_color, true, web_color(0, 0, 0));
 	lm.marker_type = m_list_style_type;
 	lm.font = get_font();
 
@@ -3297,13 +3622,12 @@ void litehtml::html_tag::render_positioned(render_type rt)
 			{
 				int offset_x = 0;
 				int offset_y = 0;
-				element::ptr cur_el = el->parent();
-				element::ptr this_el = shared_from_this();
-				while(cur_el && cur_el != this_el)
+				const element* cur_el = el->parent_ptr();
+				while(cur_el && cur_el != this)
 				{
 					offset_x += cur_el->m_pos.x;
 					offset_y += cur_el->m_pos.y;
-					cur_el = cur_el->parent();
+					cur_el = cur_el->parent_ptr();
 				}
 				if(cvt_x)	el->m_pos.x -= offset_x;
 				if(cvt_y)	el->m_pos.y -= offset_y;
@@ -3333,6 +3657,30 @@ void litehtml::html_tag::render_positioned(render_type rt)
 		{
 			return (Left->get_zindex() < Right->get_zindex());
 		});
+
+		// The fixed elements at the end of the root drawing order are drawn after all the
+		// scrolled content, so they can be drawn separately over it. The other ones keep
+		// their place, e.g. a fixed background with a negative z-index.
+		if(!have_parent() && rt != render_no_fixed)
+		{
+			auto first = m_positioned.end();
+			while(first != m_positioned.begin())
+			{
+				const element::ptr& el = *(first - 1);
+				if(el->get_element_position() != element_position_fixed || el->get_zindex() < 0)
+				{
+					break;
+				}
+				--first;
+			}
+			for(auto it = first; it != m_positioned.end(); ++it)
+			{
+				if((*it)->get_display() != display_none)
+				{
+					get_document()->add_fixed_element(*it);
+				}
+			}
+		}
 	}
 }
 
@@ -3530,6 +3878,159 @@ void litehtml::html_tag::get_redraw_box(litehtml::position& pos, int x /*= 0*/,
 	}
 }
 
+litehtml::position litehtml::html_tag::build_spatial_index()
+{
+	m_children_index.clear();
+	build_text_runs();
+
+	if(!is_visible())
+	{
+		return position();
+	}
+
+	position ink;
+	if(m_display == display_inline || m_display == display_table_row)
+	{
+		position::vector boxes;
+		get_inline_boxes(boxes);
+		for(const auto& box : boxes)
+		{
+			spatial_index::unite(ink, box);
+		}
+	} else
+	{
+		ink = m_pos;
+		ink += m_padding;
+		ink += m_borders;
+	}
+
+	if(m_display == display_list_item && m_list_style_type != list_style_type_none)
+	{
+		// list marker is painted outside of the box
+		position marker(-ink_unbounded, m_pos.y, ink_unbounded + m_pos.right(), std::max(m_pos.height, line_height()));
+		spatial_index::unite(ink, marker);
+	}
+
+	position children_ink;
+	bool unbounded = false;
+
+	if(m_grid)
+	{
+		// captions, rows and cells are positioned relative to the table
+		for(auto& caption : m_grid->captions())
+		{
+			spatial_index::unite(children_ink, caption->build_spatial_index());
+		}
+		for(int row = 0; row < m_grid->rows_count(); row++)
+		{
+			spatial_index::unite(children_ink, m_grid->row(row).el_row->build_spatial_index());
+		}
+	} else
+	{
+		for(auto& el : m_children)
+		{
+			position child_ink = el->build_spatial_index();
+
+			// cells are positioned relative to the table, not to the row
+			if(m_display != display_table_row)
+			{
+				m_children_index.add(child_ink);
+			}
+
+			if(child_ink.top() == -ink_unbounded)
+			{
+				unbounded = true;
+			}
+			spatial_index::unite(children_ink, child_ink);
+		}
+		m_children_index.finish();
+	}
+
+	if(m_el_position == element_position_fixed || unbounded)
+	{
+		return spatial_index::unbounded();
+	}
+
+	// the content is clipped by the overflow box (tables are never clipped)
+	if(m_overflow == overflow_visible || m_grid)
+	{
+		if(m_display != display_table_row)
+		{
+			children_ink.x += m_pos.x;
+			children_ink.y += m_pos.y;
+		}
+		spatial_index::unite(ink, children_ink);
+	}
+
+	return ink;
+}
+
+bool litehtml::html_tag::has_child_at_point(int x, int y) const
+{
+	if(m_children_index.size() != m_children.size())
+	{
+		return !m_children.empty();
+	}
+
+	x -= m_pos.x;
+	y -= m_pos.y;
+
+	size_t first = 0;
+	size_t last = 0;
+	m_children_index.find(y, y, first, last);
+
+	for(size_t i = first; i < last; i++)
+	{
+		if(m_children[i]->get_display() != display_inline_text && m_children_index.ink(i).is_point_inside(x, y))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool litehtml::html_tag::is_overlapped(const position& region, const element* target, const std::vector<const element*>& ancestors) const
+{
+	if(m_children_index.size() != m_children.size())
+	{
+		return !m_children.empty();
+	}
+
+	size_t first = 0;
+	size_t last = 0;
+	m_children_index.find(region.top(), region.bottom(), first, last);
+
+	for(size_t i = first; i < last; i++)
+	{
+		const position& ink = m_children_index.ink(i);
+		const element* el = m_children[i].get();
+
+		if(	el == target ||
+			!el->is_visible() ||
+			el->get_display() == display_inline_text ||
+			ink.right() <= region.left() || ink.left() >= region.right() ||
+			ink.bottom() <= region.top() || ink.top() >= region.bottom())
+		{
+			continue;
+		}
+
+		if(std::find(ancestors.begin(), ancestors.end(), el) == ancestors.end())
+		{
+			return true;
+		}
+
+		position child_region = region;
+		child_region.x -= el->m_pos.x;
+		child_region.y -= el->m_pos.y;
+
+		if(el->is_overlapped(child_region, target, ancestors))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 litehtml::element::ptr litehtml::html_tag::find_adjacent_sibling( const element::ptr& el, const css_selector& selector, bool apply_pseudo /*= true*/, bool* is_pseudo /*= 0*/ )
 {
 	element::ptr ret;
@@ -3688,7 +4189,7 @@ litehtml::element::ptr litehtml::html_tag::get_element_before()
 			return m_children.front();
 		}
 	}
-	element::ptr el = std::make_shared<el_before>(get_document());
+	element::ptr el = document_ptr()->make_element<el_before>(get_document());
 	el->parent(shared_from_this());
 	m_children.insert(m_children.begin(), el);
 	return el;
@@ -3703,7 +4204,7 @@ litehtml::element::ptr litehtml::html_tag::get_element_after()
 			return m_children.back();
 		}
 	}
-	element::ptr el = std::make_shared<el_after>(get_document());
+	element::ptr el = document_ptr()->make_element<el_after>(get_document());
 	appendChild(el);
 	return el;
 }
@@ -3817,9 +4318,25 @@ litehtml::element::ptr litehtml::html_tag::get_child_by_point(int x, int y, int
 	pos.x	= x - pos.x;
 	pos.y	= y - pos.y;
 
-	for(auto i = m_children.rbegin(); i != m_children.rend() && !ret; i++)
+	// only the children whose ink box contains the point can be hit
+	size_t first = 0;
+	size_t last = m_children.size();
+	bool use_index = m_children_index.size() == m_children.size();
+
+	if(use_index)
 	{
-		element::ptr el = (*i);
+		m_children_index.find(pos.y, pos.y, first, last);
+	}
+
+	for(size_t i = last; i > first && !ret; i--)
+	{
+		if(use_index && !m_children_index.ink(i - 1).is_point_inside(pos.x, pos.y))
+		{
+			continue;
+		}
+
+		const element::ptr& child = m_children[i - 1];
+		element::ptr el = child;
 
 		if(el->is_visible() && el->get_display() != display_inline_text)
 		{
@@ -3831,16 +4348,16 @@ litehtml::element::ptr litehtml::html_tag::get_child_by_point(int x, int y, int
 					if(el->get_element_position() == element_position_fixed)
 					{
 						ret = el->get_element_by_point(client_x, client_y, client_x, client_y);
-						if(!ret && (*i)->is_point_inside(client_x, client_y))
+						if(!ret && child->is_point_inside(client_x, client_y))
 						{
-							ret = (*i);
+							ret = child;
 						}
 					} else
 					{
 						ret = el->get_element_by_point(pos.x, pos.y, client_x, client_y);
-						if(!ret && (*i)->is_point_inside(pos.x, pos.y))
+						if(!ret && child->is_point_inside(pos.x, pos.y))
 						{
-							ret = (*i);
+							ret = child;
 						}
 					}
 					el = nullptr;
@@ -3860,9 +4377,9 @@ litehtml::element::ptr litehtml::html_tag::get_child_by_point(int x, int y, int
 				{
 					ret = el->get_element_by_point(pos.x, pos.y, client_x, client_y);
 
-					if(!ret && (*i)->is_point_inside(pos.x, pos.y))
+					if(!ret && child->is_point_inside(pos.x, pos.y))
 					{
-						ret = (*i);
+						ret = child;
 					}
 					el = nullptr;
 				}
@@ -3875,9 +4392,9 @@ litehtml::element::ptr litehtml::html_tag::get_child_by_point(int x, int y, int
 						ret = el->get_element_by_point(pos.x, pos.y, client_x, client_y);
 						el = nullptr;
 					}
-					if(!ret && (*i)->is_point_inside(pos.x, pos.y))
+					if(!ret && child->is_point_inside(pos.x, pos.y))
 					{
-						ret = (*i);
+						ret = child;
 					}
 				}
 				break;
@@ -4221,14 +4738,14 @@ int litehtml::html_tag::render_box(int x, int y, int max_width, bool second_pass
 
 	if (m_display == display_list_item)
 	{
-		const tchar_t* list_image = get_style_property(_t("list-style-image"), true, nullptr);
+		const tchar_t* list_image = get_style_property(css_property_list_style_image, true, nullptr);
 		if (list_image)
 		{
 			tstring url;
 			css::parse_css_url(list_image, url);
 
 			size sz;
-			const tchar_t* list_image_baseurl = get_style_property(_t("list-style-image-baseurl"), true, nullptr);
+			const tchar_t* list_image_baseurl = get_style_property(css_property_list_style_image_baseurl, true, nullptr);
 			get_document()->container()->get_image_size(url.c_str(), list_image_baseurl, sz);
 			if (min_height < sz.height)
 			{
@@ -4694,10 +5211,31 @@ void litehtml::html_tag::draw_children_box(uint_ptr hdc, int x, int y, const pos
 		doc->container()->set_clip(hdc, pos, bdr_radius, true, true);
 	}
 
+	// cull the children using the spatial index built after the layout
+	size_t first = 0;
+	size_t last = m_children.size();
+	position children_clip;
+	bool use_index = clip && m_children_index.size() == m_children.size();
+
+	if (use_index)
+	{
+		children_clip = *clip;
+		children_clip.x -= pos.x;
+		children_clip.y -= pos.y;
+		m_children_index.find(children_clip.top(), children_clip.bottom(), first, last);
+	}
+
+	bool use_runs = flag == draw_inlines && m_children_runs.size() == m_children.size();
+
 	element::ptr el;
-	for (auto& item : m_children)
+	for (size_t i = first; i < last; i++)
 	{
-		el = item;
+		if (use_index && !m_children_index.ink(i).does_intersect(&children_clip))
+		{
+			continue;
+		}
+
+		el = m_children[i];
 		if (el->is_visible())
 		{
 			switch (flag)
@@ -4707,11 +5245,20 @@ void litehtml::html_tag::draw_children_box(uint_ptr hdc, int x, int y, const pos
 				{
 					if (el->get_element_position() == element_position_fixed)
 					{
+						if (doc->is_drawn_separately(el))
+						{
+							el = nullptr;
+							break;
+						}
+
                         position browser_wnd;
                         doc->container()->get_client_rect(browser_wnd);
 
+						// drawn relative to the client area within the scrolled content
+						doc->container()->begin_fixed(hdc);
 						el->draw(hdc, browser_wnd.x, browser_wnd.y, clip);
 						el->draw_stacking_context(hdc, browser_wnd.x, browser_wnd.y, clip, true);
+						doc->container()->end_fixed(hdc);
 					}
 					else
 					{
@@ -4736,7 +5283,14 @@ void litehtml::html_tag::draw_children_box(uint_ptr hdc, int x, int y, const pos
 				}
 				break;
 			case draw_inlines:
-				if (el->is_inline_box() && el->get_float() == float_none && !el->is_positioned())
+				if (use_runs && m_children_runs[i] >= 0)
+				{
+					// the whole run is drawn by the first visited word
+					const text_run& run = m_text_runs[m_children_runs[i]];
+					draw_text_run(hdc, pos.x, pos.y, clip, run);
+					i = run.last;
+					el = nullptr;
+				} else if (el->is_inline_box() && el->get_float() == float_none && !el->is_positioned())
 				{
 					el->draw(hdc, pos.x, pos.y, clip);
 					if (el->get_display() == display_inline_block)
@@ -4778,6 +5332,102 @@ void litehtml::html_tag::draw_children_box(uint_ptr hdc, int x, int y, const pos
 	}
 }
 
+void litehtml::html_tag::build_text_runs()
+{
+	m_text_runs.clear();
+	m_children_runs.clear();
+
+	if(m_children.size() < 2)
+	{
+		return;
+	}
+
+	m_children_runs.resize(m_children.size(), -1);
+
+	auto is_run_word = [](const element::ptr& el)
+	{
+		return el->get_draw_text() && el->is_visible() && !el->is_positioned() && el->get_float() == float_none;
+	};
+
+	size_t i = 0;
+	while(i < m_children.size())
+	{
+		if(!is_run_word(m_children[i]))
+		{
+			i++;
+			continue;
+		}
+
+		// extend the run while the next word continues the same line
+		size_t last = i;
+		while(last + 1 < m_children.size() && is_run_word(m_children[last + 1]))
+		{
+			const position& prev = m_children[last]->m_pos;
+			const position& next = m_children[last + 1]->m_pos;
+			if(next.x != prev.right() || next.y != prev.y || next.height != prev.height)
+			{
+				break;
+			}
+			last++;
+		}
+
+		if(last > i)
+		{
+			text_run run;
+			run.id		= text_run::new_id();
+			run.first	= i;
+			run.last	= last;
+			run.pos		= m_children[i]->m_pos;
+			run.pos.width = m_children[last]->m_pos.right() - run.pos.x;
+
+			for(size_t j = i; j <= last; j++)
+			{
+				const element::ptr& el = m_children[j];
+				if(el->is_white_space() && !m_font_metrics.draw_spaces)
+				{
+					continue;
+				}
+				text_run_part part;
+				part.text	= el->get_draw_text();
+				part.x		= el->m_pos.x - run.pos.x;
+				part.width	= el->m_pos.width;
+				run.parts.push_back(std::move(part));
+			}
+
+			for(size_t j = i; j <= last; j++)
+			{
+				m_children_runs[j] = (int) m_text_runs.size();
+			}
+			m_text_runs.push_back(std::move(run));
+		}
+		i = last + 1;
+	}
+
+	if(m_text_runs.empty())
+	{
+		m_children_runs.clear();
+	}
+}
+
+void litehtml::html_tag::draw_text_run(uint_ptr hdc, int x, int y, const position* clip, const text_run& run)
+{
+	if(run.parts.empty())
+	{
+		return;
+	}
+
+	position pos = run.pos;
+	pos.x += x;
+	pos.y += y;
+
+	if(pos.does_intersect(clip))
+	{
+		document::ptr doc = get_document();
+		web_color color = get_color(css_property_color, true, doc->get_def_color());
+		doc->container()->draw_text_run(hdc, run, m_font, color, pos);
+	}
+}
+
 void litehtml::html_tag::draw_children_table(uint_ptr hdc, int x, int y, const position* clip, draw_flag flag, int zindex)
 {
 	if (!m_grid) return;
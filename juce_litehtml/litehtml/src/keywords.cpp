@@ -0,0 +1,32 @@
+#include "html.h"
+#include "keywords.h"
+
+#define LITEHTML_KEYWORDS(name)	constexpr decltype(litehtml::name##_keywords) litehtml::name##_keywords(name##_strings)
+
+LITEHTML_KEYWORDS(style_display);
+LITEHTML_KEYWORDS(font_style);
+LITEHTML_KEYWORDS(font_variant);
+LITEHTML_KEYWORDS(font_weight);
+LITEHTML_KEYWORDS(list_style_type);
+LITEHTML_KEYWORDS(list_style_position);
+LITEHTML_KEYWORDS(vertical_align);
+LITEHTML_KEYWORDS(border_width);
+LITEHTML_KEYWORDS(border_style);
+LITEHTML_KEYWORDS(element_float);
+LITEHTML_KEYWORDS(element_clear);
+LITEHTML_KEYWORDS(css_units);
+LITEHTML_KEYWORDS(background_attachment);
+LITEHTML_KEYWORDS(background_repeat);
+LITEHTML_KEYWORDS(background_box);
+LITEHTML_KEYWORDS(element_position);
+LITEHTML_KEYWORDS(text_align);
+LITEHTML_KEYWORDS(text_transform);
+LITEHTML_KEYWORDS(white_space);
+LITEHTML_KEYWORDS(overflow);
+LITEHTML_KEYWORDS(visibility);
+LITEHTML_KEYWORDS(border_collapse);
+LITEHTML_KEYWORDS(box_sizing);
+LITEHTML_KEYWORDS(pseudo_class);
+LITEHTML_KEYWORDS(media_orientation);
+LITEHTML_KEYWORDS(media_feature);
+LITEHTML_KEYWORDS(media_type);
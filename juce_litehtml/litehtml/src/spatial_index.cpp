@@ -0,0 +1,78 @@
+#include "html.h"
+#include "spatial_index.h"
+
+void litehtml::spatial_index::clear()
+{
+	m_ink.clear();
+	m_max_bottom.clear();
+	m_min_top.clear();
+}
+
+void litehtml::spatial_index::add(const position& ink)
+{
+	m_ink.push_back(ink);
+}
+
+void litehtml::spatial_index::finish()
+{
+	m_max_bottom.resize(m_ink.size());
+	m_min_top.resize(m_ink.size());
+
+	// Empty boxes paint nothing and must not widen the search range
+	int max_bottom = -ink_unbounded;
+	for(size_t i = 0; i < m_ink.size(); i++)
+	{
+		if(!m_ink[i].empty())
+		{
+			max_bottom = std::max(max_bottom, m_ink[i].bottom());
+		}
+		m_max_bottom[i] = max_bottom;
+	}
+
+	int min_top = ink_unbounded;
+	for(size_t i = m_ink.size(); i > 0; i--)
+	{
+		if(!m_ink[i - 1].empty())
+		{
+			min_top = std::min(min_top, m_ink[i - 1].top());
+		}
+		m_min_top[i - 1] = min_top;
+	}
+}
+
+void litehtml::spatial_index::find(int top, int bottom, size_t& first, size_t& last) const
+{
+	first	= std::lower_bound(m_max_bottom.begin(), m_max_bottom.end(), top) - m_max_bottom.begin();
+	last	= std::upper_bound(m_min_top.begin(), m_min_top.end(), bottom) - m_min_top.begin();
+	if(last < first)
+	{
+		last = first;
+	}
+}
+
+litehtml::position litehtml::spatial_index::unbounded()
+{
+	return position(-ink_unbounded, -ink_unbounded, ink_unbounded * 2, ink_unbounded * 2);
+}
+
+void litehtml::spatial_index::unite(position& dst, const position& src)
+{
+	if(src.empty())
+	{
+		return;
+	}
+	if(dst.empty())
+	{
+		dst = src;
+		return;
+	}
+	int left	= std::min(dst.left(),		src.left());
+	int top		= std::min(dst.top(),		src.top());
+	int right	= std::max(dst.right(),		src.right());
+	int bottom	= std::max(dst.bottom(),	src.bottom());
+
+	dst.x		= left;
+	dst.y		= top;
+	dst.width	= right - left;
+	dst.height	= bottom - top;
+}
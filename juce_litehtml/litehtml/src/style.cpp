@@ -4,14 +4,30 @@
 #include <locale>
 #endif
 
-litehtml::string_map litehtml::style::m_valid_values =
+static constexpr litehtml::keyword_table<litehtml::keyword_count(css_property_strings)> css_property_names(css_property_strings);
+
+litehtml::css_property litehtml::css_property_id( const tchar_t* name )
 {
-	{ _t("white-space"), white_space_strings }
-};
+	return (css_property) css_property_names.find(name, css_property_unknown);
+}
 
-litehtml::style::style( const style& val )
+const litehtml::tchar_t* litehtml::style::get_property( const tchar_t* name ) const
 {
-	m_properties = val.m_properties;
+	if(name)
+	{
+		css_property id = css_property_id(name);
+		if(id != css_property_unknown)
+		{
+			return get_property(id);
+		}
+
+		auto f = m_custom.find(name);
+		if(f != m_custom.end())
+		{
+			return f->second.m_value.c_str();
+		}
+	}
+	return nullptr;
 }
 
 void litehtml::style::parse( const tchar_t* txt, const tchar_t* baseurl, const element* el )
@@ -55,12 +71,70 @@ void litehtml::style::parse_property( const tstring& txt, const tchar_t* baseurl
 
 void litehtml::style::combine( const litehtml::style& src )
 {
-	for(const auto& property : src.m_properties)
+	size_t pos = 0;
+	for(int id = 0; id < css_property_count; id++)
+	{
+		if(src.m_set.test(id))
+		{
+			const property_value& property = src.m_values[pos++];
+			add_parsed_property((css_property) id, property.m_value, property.m_important);
+		}
+	}
+	for(const auto& property : src.m_custom)
 	{
 		add_parsed_property(property.first, property.second.m_value, property.second.m_important);
 	}
 }
 
+litehtml::computed_style::ptr litehtml::style::compute( const computed_style::ptr& parent ) const
+{
+	// the inherited properties come first in m_values
+	size_t inherited = (m_set << (css_property_count - css_inherited_count)).count();
+
+	bool custom = false;
+	for(const auto& property : m_custom)
+	{
+		if(!property.first.compare(0, 2, _t("--")))
+		{
+			custom = true;
+			break;
+		}
+	}
+
+	if(!inherited && !custom)
+	{
+		return parent;
+	}
+
+	std::shared_ptr<computed_style> ret = parent ? std::make_shared<computed_style>(*parent) : std::make_shared<computed_style>();
+
+	size_t pos = 0;
+	for(int id = 0; id < css_inherited_count && pos < inherited; id++)
+	{
+		if(m_set.test(id))
+		{
+			const tstring& val = m_values[pos++].m_value;
+			if(t_strcasecmp(val.c_str(), _t("inherit")))
+			{
+				ret->set_property((css_property) id, val);
+			}
+		}
+	}
+
+	if(custom)
+	{
+		for(const auto& property : m_custom)
+		{
+			if(!property.first.compare(0, 2, _t("--")) && t_strcasecmp(property.second.m_value.c_str(), _t("inherit")))
+			{
+				ret->m_custom[property.first] = property.second.m_value;
+			}
+		}
+	}
+
+	return ret;
+}
+
 void litehtml::style::subst_vars( tstring& str, const element* el )
 {
 	if (!el) return;
@@ -126,7 +200,7 @@ void litehtml::style::add_property( const tchar_t* name, const tchar_t* _val, co
 		tstring str;
 		for(const auto& token : tokens)
 		{
-			idx = value_index(token, border_style_strings, -1);
+			idx = value_index(token, border_style_keywords, -1);
 			if(idx >= 0)
 			{
 				add_property(_t("border-left-style"), token.c_str(), baseurl, important, el);
@@ -163,7 +237,7 @@ void litehtml::style::add_property( const tchar_t* name, const tchar_t* _val, co
 		tstring str;
 		for(const auto& token : tokens)
 		{
-			idx = value_index(token, border_style_strings, -1);
+			idx = value_index(token, border_style_keywords, -1);
 			if(idx >= 0)
 			{
 				str = name;
@@ -332,13 +406,13 @@ void litehtml::style::add_property( const tchar_t* name, const tchar_t* _val, co
 		split_string(val, tokens, _t(" "), _t(""), _t("("));
 		for(const auto& token : tokens)
 		{
-			int idx = value_index(token, list_style_type_strings, -1);
+			int idx = value_index(token, list_style_type_keywords, -1);
 			if(idx >= 0)
 			{
 				add_parsed_property(_t("list-style-type"), token, important);
 			} else
 			{
-				idx = value_index(token, list_style_position_strings, -1);
+				idx = value_index(token, list_style_position_keywords, -1);
 				if(idx >= 0)
 				{
 					add_parsed_property(_t("list-style-position"), token, important);
@@ -471,7 +545,7 @@ void litehtml::style::parse_short_border( const tstring& prefix, const tstring&
 		add_parsed_property(prefix + _t("-color"),	tokens[2], important);
 	} else if(tokens.size() == 2)
 	{
-		if(iswdigit(tokens[0][0]) || value_index(val, border_width_strings) >= 0)
+		if(iswdigit(tokens[0][0]) || value_index(val, border_width_keywords) >= 0)
 		{
 			add_parsed_property(prefix + _t("-width"),	tokens[0], important);
 			add_parsed_property(prefix + _t("-style"),	tokens[1], important);
@@ -511,13 +585,13 @@ void litehtml::style::parse_short_background( const tstring& val, const tchar_t*
 				add_parsed_property(_t("background-image-baseurl"), baseurl, important);
 			}
 
-		} else if( value_in_list(token, background_repeat_strings) )
+		} else if( value_in_list(token, background_repeat_keywords) )
 		{
 			add_parsed_property(_t("background-repeat"), token, important);
-		} else if( value_in_list(token, background_attachment_strings) )
+		} else if( value_in_list(token, background_attachment_keywords) )
 		{
 			add_parsed_property(_t("background-attachment"), token, important);
-		} else if( value_in_list(token, background_box_strings) )
+		} else if( value_in_list(token, background_box_keywords) )
 		{
 			if(!origin_found)
 			{
@@ -533,9 +607,11 @@ void litehtml::style::parse_short_background( const tstring& val, const tchar_t*
 					token[0] == _t('.')	||
 					token[0] == _t('+'))
 		{
-			if(m_properties.find(_t("background-position")) != m_properties.end())
+			if(m_set.test(css_property_background_position))
 			{
-				m_properties[_t("background-position")].m_value = m_properties[_t("background-position")].m_value + _t(" ") + token;
+				tstring& pos = m_values[value_pos(css_property_background_position)].m_value;
+				pos += _t(" ");
+				pos += token;
 			} else
 			{
 				add_parsed_property(_t("background-position"), token, important);
@@ -563,7 +639,7 @@ void litehtml::style::parse_short_font( const tstring& val, bool important )
 	tstring font_family;
 	for(const auto& token : tokens)
 	{
-		idx = value_index(token, font_style_strings);
+		idx = value_index(token, font_style_keywords);
 		if(!is_family)
 		{
 			if(idx >= 0)
@@ -579,12 +655,12 @@ void litehtml::style::parse_short_font( const tstring& val, bool important )
 				}
 			} else
 			{
-				if(value_in_list(token, font_weight_strings))
+				if(value_in_list(token, font_weight_keywords))
 				{
 					add_parsed_property(_t("font-weight"), token, important);
 				} else
 				{
-					if(value_in_list(token, font_variant_strings))
+					if(value_in_list(token, font_variant_keywords))
 					{
 						add_parsed_property(_t("font-variant"), token, important);
 					} else if( iswdigit(token[0]) )
@@ -617,42 +693,75 @@ void litehtml::style::parse_short_font( const tstring& val, bool important )
 
 void litehtml::style::add_parsed_property( const tstring& name, const tstring& val, bool important )
 {
-	bool is_valid = true;
-	auto vals = m_valid_values.find(name);
-	if (vals != m_valid_values.end())
+	css_property id = css_property_id(name.c_str());
+	if(id != css_property_unknown)
 	{
-		if (!value_in_list(val, vals->second))
-		{
-			is_valid = false;
-		}
+		add_parsed_property(id, val, important);
+		return;
 	}
 
-	if (is_valid)
+	auto prop = m_custom.find(name);
+	if (prop != m_custom.end())
 	{
-		auto prop = m_properties.find(name);
-		if (prop != m_properties.end())
+		if (!prop->second.m_important || important)
 		{
-			if (!prop->second.m_important || (important && prop->second.m_important))
-			{
-				prop->second.m_value = val;
-				prop->second.m_important = important;
-			}
+			prop->second.m_value = val;
+			prop->second.m_important = important;
 		}
-		else
+	}
+	else
+	{
+		m_custom[name] = property_value(val.c_str(), important);
+	}
+}
+
+void litehtml::style::add_parsed_property( css_property id, const tstring& val, bool important )
+{
+	if (id == css_property_white_space && !value_in_list(val, white_space_keywords))
+	{
+		return;
+	}
+
+	size_t pos = value_pos(id);
+	if (m_set.test(id))
+	{
+		property_value& prop = m_values[pos];
+		if (!prop.m_important || important)
 		{
-			m_properties[name] = property_value(val.c_str(), important);
+			prop.m_value = val;
+			prop.m_important = important;
 		}
 	}
+	else
+	{
+		m_values.insert(m_values.begin() + pos, property_value(val.c_str(), important));
+		m_set.set(id);
+	}
 }
 
 void litehtml::style::remove_property( const tstring& name, bool important )
 {
-	auto prop = m_properties.find(name);
-	if(prop != m_properties.end())
+	css_property id = css_property_id(name.c_str());
+	if(id != css_property_unknown)
+	{
+		if(m_set.test(id))
+		{
+			size_t pos = value_pos(id);
+			if( !m_values[pos].m_important || important )
+			{
+				m_values.erase(m_values.begin() + pos);
+				m_set.reset(id);
+			}
+		}
+		return;
+	}
+
+	auto prop = m_custom.find(name);
+	if(prop != m_custom.end())
 	{
-		if( !prop->second.m_important || (important && prop->second.m_important) )
+		if( !prop->second.m_important || important )
 		{
-			m_properties.erase(prop);
+			m_custom.erase(prop);
 		}
 	}
 }
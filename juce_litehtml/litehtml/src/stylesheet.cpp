@@ -4,7 +4,7 @@
 #include "document.h"
 
 
-void litehtml::css::parse_stylesheet(const tchar_t* str, const tchar_t* baseurl, const std::shared_ptr<document>& doc, const media_query_list::ptr& media)
+void litehtml::css::parse_stylesheet(const tchar_t* str, const tchar_t* baseurl, const std::shared_ptr<document>& doc, const media_query_list::ptr& media, atom_table& atoms)
 {
 	tstring text = str;
 
@@ -30,10 +30,10 @@ void litehtml::css::parse_stylesheet(const tchar_t* str, const tchar_t* baseurl,
 			}
 			if(pos != tstring::npos)
 			{
-				parse_atrule(text.substr(sPos, pos - sPos + 1), baseurl, doc, media);
+				parse_atrule(text.substr(sPos, pos - sPos + 1), baseurl, doc, media, atoms);
 			} else
 			{
-				parse_atrule(text.substr(sPos), baseurl, doc, media);
+				parse_atrule(text.substr(sPos), baseurl, doc, media, atoms);
 			}
 
 			if(pos != tstring::npos)
@@ -53,7 +53,7 @@ void litehtml::css::parse_stylesheet(const tchar_t* str, const tchar_t* baseurl,
 		{
 			auto style = text.substr(style_start + 1, style_end - style_start - 1);
 
-			parse_selectors(text.substr(pos, style_start - pos), style, media, baseurl ? baseurl : _t(""));
+			parse_selectors(text.substr(pos, style_start - pos), style, media, baseurl ? baseurl : _t(""), atoms);
 
 			if(media && doc)
 			{
@@ -98,7 +98,7 @@ void litehtml::css::parse_css_url( const tstring& str, tstring& url )
 	}
 }
 
-bool litehtml::css::parse_selectors( const tstring& txt, const tstring& styles, const media_query_list::ptr& media, const tstring& baseurl )
+bool litehtml::css::parse_selectors( const tstring& txt, const tstring& styles, const media_query_list::ptr& media, const tstring& baseurl, atom_table& atoms )
 {
 	tstring selector = txt;
 	trim(selector);
@@ -112,9 +112,11 @@ bool litehtml::css::parse_selectors( const tstring& txt, const tstring& styles,
 		css_selector::ptr new_selector = std::make_shared<css_selector>(media, baseurl);
         new_selector->m_style = styles;
 		trim(token);
-		if(new_selector->parse(token))
+		if(new_selector->parse(token, atoms))
 		{
 			new_selector->calc_specificity();
+			new_selector->calc_ancestor_keys();
+			new_selector->calc_sibling_dependence();
 			add_selector(new_selector);
 			added_something = true;
 		}
@@ -131,9 +133,85 @@ void litehtml::css::sort_selectors()
 			 return (*v1) < (*v2);
 		 }
 	);
+
+	m_id_rules.clear();
+	m_class_rules.clear();
+	m_tag_rules.clear();
+	m_universal_rules.clear();
+	for(int i = 0; i < (int) m_selectors.size(); i++)
+	{
+		add_rule(i);
+	}
+}
+
+void litehtml::css::add_rule(int idx)
+{
+	const css_element_selector& right = m_selectors[idx]->m_right;
+
+	for(const auto& attr : right.m_attrs)
+	{
+		if(attr.condition == select_equal && attr.attribute == atom_id())
+		{
+			m_id_rules[attr.val_atom].push_back(idx);
+			return;
+		}
+	}
+	for(const auto& attr : right.m_attrs)
+	{
+		if(attr.condition == select_equal && attr.attribute == atom_class() && !attr.class_val.empty())
+		{
+			m_class_rules[attr.class_val.front()].push_back(idx);
+			return;
+		}
+	}
+	if(right.m_tag)
+	{
+		m_tag_rules[right.m_tag].push_back(idx);
+		return;
+	}
+	m_universal_rules.push_back(idx);
+}
+
+void litehtml::css::get_candidates(atom id, const std::vector<atom>& classes, atom tag, int_vector& res) const
+{
+	res.clear();
+
+	auto append = [&res](const rules_map& rules, atom key)
+	{
+		auto iter = rules.find(key);
+		if(iter != rules.end())
+		{
+			res.insert(res.end(), iter->second.begin(), iter->second.end());
+		}
+	};
+
+	if(id)
+	{
+		append(m_id_rules, id);
+	}
+	for(atom cls : classes)
+	{
+		append(m_class_rules, cls);
+	}
+	if(tag)
+	{
+		append(m_tag_rules, tag);
+	}
+	size_t merged = res.size();
+	res.insert(res.end(), m_universal_rules.begin(), m_universal_rules.end());
+
+	// each group is sorted, but the groups are interleaved in the cascade
+	if(merged)
+	{
+		std::sort(res.begin(), res.end());
+		if(classes.size() > 1)
+		{
+			res.erase(std::unique(res.begin(), res.end()), res.end());
+		}
+	}
 }
 
-void litehtml::css::parse_atrule(const tstring& text, const tchar_t* baseurl, const std::shared_ptr<document>& doc, const media_query_list::ptr& media)
+void litehtml::css::parse_atrule(const tstring& text, const tchar_t* baseurl, const std::shared_ptr<document>& doc, const media_query_list::ptr& media, atom_table& atoms)
 {
 	if(text.substr(0, 7) == _t("@import"))
 	{
@@ -188,7 +266,7 @@ void litehtml::css::parse_atrule(const tstring& text, const tchar_t* baseurl, co
 								new_media = media;
 							}
 						}
-						parse_stylesheet(css_text.c_str(), css_baseurl.c_str(), doc, new_media);
+						parse_stylesheet(css_text.c_str(), css_baseurl.c_str(), doc, new_media, atoms);
 					}
 				}
 			}
@@ -212,7 +290,7 @@ void litehtml::css::parse_atrule(const tstring& text, const tchar_t* baseurl, co
 				media_style = text.substr(b1 + 1);
 			}
 
-			parse_stylesheet(media_style.c_str(), baseurl, doc, new_media);
+			parse_stylesheet(media_style.c_str(), baseurl, doc, new_media, atoms);
 		}
 	}
 }
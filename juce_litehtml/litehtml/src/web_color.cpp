@@ -2,7 +2,7 @@
 #include "web_color.h"
 #include <cstring>
 
-litehtml::def_color litehtml::g_def_colors[] = 
+constexpr litehtml::def_color litehtml::g_def_colors[] = 
 {
 	{_t("transparent"),_t("rgba(0, 0, 0, 0)")},
 	{_t("AliceBlue"),_t("#F0F8FF")},
@@ -225,14 +225,15 @@ litehtml::web_color litehtml::web_color::from_string(const tchar_t* str, litehtm
 	return web_color(0, 0, 0);
 }
 
+// the names are matched ignoring the case, the last entry is the terminator
+static constexpr litehtml::keyword_table<sizeof(litehtml::g_def_colors) / sizeof(litehtml::g_def_colors[0]) - 1> def_color_names(litehtml::g_def_colors, &litehtml::def_color::name, true);
+
 litehtml::tstring litehtml::web_color::resolve_name(const tchar_t* name, litehtml::document_container* callback)
 {
-	for(int i=0; g_def_colors[i].name; i++)
+	int idx = def_color_names.find(name);
+	if(idx >= 0)
 	{
-		if(!t_strcasecmp(name, g_def_colors[i].name))
-		{
-            return litehtml::tstring(g_def_colors[i].rgb);
-		}
+		return litehtml::tstring(g_def_colors[idx].rgb);
 	}
     if (callback)
     {
@@ -0,0 +1,469 @@
+namespace juce_litehtml {
+
+/** Recorded sequence of drawing operations.
+
+    The document gets drawn into a display list once after the layout,
+    which is then replayed on every paint with the operations outside
+    of the painted area skipped. A recorded list is not modified when
+    replaying, so it can be replayed from several threads at once.
+*/
+class DisplayList final
+{
+public:
+
+    DisplayList() = default;
+
+    void clear()
+    {
+        ops.clear();
+        paths.clear();
+        glyphs.clear();
+        images.clear();
+    }
+
+    bool isEmpty() const noexcept { return ops.empty(); }
+
+    /** Return the area covered by the drawing operations. */
+    Rectangle<float> getBounds() const
+    {
+        Rectangle<float> bounds;
+
+        for (const auto& op : ops)
+        {
+            if (isDrawing (op))
+                bounds = bounds.getUnion (op.bounds);
+        }
+
+        return bounds;
+    }
+
+    //==========================================================================
+    // Recording
+
+    void fillRect (const Rectangle<int>& area, Colour colour)
+    {
+        if (! area.isEmpty())
+            ops.push_back ({ OpType::fillRect, area.toFloat(), colour });
+    }
+
+    void fillPath (Path&& path, Colour colour)
+    {
+        if (path.isEmpty())
+            return;
+
+        ops.push_back ({ OpType::fillPath, path.getBounds(), colour, (int) paths.size() });
+        paths.push_back (std::move (path));
+    }
+
+    void fillEllipse (const Rectangle<float>& area, Colour colour)
+    {
+        ops.push_back ({ OpType::fillEllipse, area, colour });
+    }
+
+    void drawEllipse (const Rectangle<float>& area, Colour colour)
+    {
+        ops.push_back ({ OpType::drawEllipse, area.expanded (0.5f), colour });
+    }
+
+    void drawRect (const Rectangle<float>& area, Colour colour)
+    {
+        ops.push_back ({ OpType::drawRect, area, colour });
+    }
+
+    void drawGlyphs (std::shared_ptr<const GlyphArrangement> arrangement, Point<float> origin, Colour colour)
+    {
+        if (arrangement == nullptr || arrangement->getNumGlyphs() == 0)
+            return;
+
+        const auto bounds { arrangement->getBoundingBox (0, -1, true).translated (origin.x, origin.y) };
+
+        ops.push_back ({ OpType::drawGlyphs, bounds, colour, (int) glyphs.size() });
+        glyphs.push_back ({ std::move (arrangement), origin });
+    }
+
+    void drawImage (const Image& image, const Rectangle<float>& area, RectanglePlacement placement)
+    {
+        if (image.isNull())
+            return;
+
+        // The placement may scale the image beyond the target area
+        const auto transform { placement.getTransformToFit (image.getBounds().toFloat(), area) };
+        const auto bounds { image.getBounds().toFloat().transformedBy (transform) };
+
+        ops.push_back ({ OpType::drawImage, bounds, {}, (int) images.size() });
+        images.push_back ({ image, area, placement });
+    }
+
+    void pushClip (const Rectangle<int>& area)
+    {
+        ops.push_back ({ OpType::pushClip, area.toFloat() });
+    }
+
+    void popClip()
+    {
+        ops.push_back ({ OpType::popClip });
+    }
+
+    /** Start the operations of a fixed box drawn within the scrolled content.
+
+        These are recorded relative to the viewport rather than the document,
+        so they follow the scroll position given when replaying.
+     */
+    void pushFixed()
+    {
+        ops.push_back ({ OpType::pushFixed });
+    }
+
+    void popFixed()
+    {
+        ops.push_back ({ OpType::popFixed });
+    }
+
+    //==========================================================================
+
+    /** Simplify the recorded operations.
+
+        This should be called once the recording is complete, it
+        also enables skipping the clipped out parts when replaying.
+     */
+    void optimise()
+    {
+        dropInvisibleFills();
+        mergeFills();
+        elideClips();
+        matchClips();
+    }
+
+    /** Replay the operations.
+
+        Only the operations within the graphics context clip get drawn.
+
+        @param g        Graphics context to draw to.
+        @param area     Area of the recorded coordinates to be drawn
+                        at the graphics context origin.
+        @param scroll   Scroll position the fixed boxes recorded within
+                        the content are drawn at.
+     */
+    void replay (Graphics& g, const Rectangle<int>& area, Point<int> scroll = {}) const
+    {
+        Graphics::ScopedSaveState state (g);
+        g.setOrigin (-area.getPosition());
+
+        const auto contentVisible { area.getIntersection (g.getClipBounds()).toFloat() };
+        auto visible { contentVisible };
+        int fixedDepth { 0 };
+
+        for (size_t i = 0; i < ops.size(); ++i)
+        {
+            const auto& op { ops[i] };
+
+            if (op.type == OpType::popClip)
+            {
+                g.restoreState();
+                continue;
+            }
+
+            // The descendants of a fixed box are drawn relative to the viewport too
+            if (op.type == OpType::pushFixed)
+            {
+                if (fixedDepth++ == 0)
+                {
+                    g.saveState();
+                    g.setOrigin (scroll);
+                    visible = contentVisible - scroll.toFloat();
+                }
+
+                continue;
+            }
+
+            if (op.type == OpType::popFixed)
+            {
+                if (--fixedDepth == 0)
+                {
+                    g.restoreState();
+                    visible = contentVisible;
+                }
+
+                continue;
+            }
+
+            if (! op.bounds.intersects (visible))
+            {
+                if (op.type != OpType::pushClip)
+                    continue;
+
+                // Skip everything clipped out, along with the clip itself
+                if (op.index >= 0)
+                {
+                    i = (size_t) op.index;
+                    continue;
+                }
+            }
+
+            switch (op.type)
+            {
+                case OpType::fillRect:
+                    g.setColour (op.colour);
+                    g.fillRect (op.bounds);
+                    break;
+
+                case OpType::fillPath:
+                    g.setColour (op.colour);
+                    g.fillPath (paths[(size_t) op.index]);
+                    break;
+
+                case OpType::fillEllipse:
+                    g.setColour (op.colour);
+                    g.fillEllipse (op.bounds);
+                    break;
+
+                case OpType::drawEllipse:
+                    g.setColour (op.colour);
+                    g.drawEllipse (op.bounds.reduced (0.5f), 1.0f);
+                    break;
+
+                case OpType::drawRect:
+                    g.setColour (op.colour);
+                    g.drawRect (op.bounds);
+                    break;
+
+                case OpType::drawGlyphs:
+                {
+                    const auto& item { glyphs[(size_t) op.index] };
+                    g.setColour (op.colour);
+                    item.arrangement->draw (g, AffineTransform::translation (item.origin));
+                    break;
+                }
+
+                case OpType::drawImage:
+                {
+                    const auto& item { images[(size_t) op.index] };
+                    g.setOpacity (1.0f);
+                    g.drawImage (item.image, item.area, item.placement);
+                    break;
+                }
+
+                case OpType::pushClip:
+                    g.saveState();
+                    g.reduceClipRegion (op.bounds.toNearestInt());
+                    break;
+
+                case OpType::popClip:
+                default:
+                    break;
+            }
+        }
+    }
+
+private:
+
+    enum class OpType
+    {
+        fillRect,
+        fillPath,
+        fillEllipse,
+        drawEllipse,
+        drawRect,
+        drawGlyphs,
+        drawImage,
+        pushClip,
+        popClip,
+        pushFixed,
+        popFixed
+    };
+
+    struct Op
+    {
+        OpType type;
+        Rectangle<float> bounds {};     // Painted area, or the clip area
+        Colour colour {};
+        int index { -1 };               // Payload index, or the matching popClip
+    };
+
+    struct Glyphs
+    {
+        std::shared_ptr<const GlyphArrangement> arrangement;
+        Point<float> origin;
+    };
+
+    struct ImageItem
+    {
+        Image image;
+        Rectangle<float> area;
+        RectanglePlacement placement;
+    };
+
+    static bool isDrawing (const Op& op)
+    {
+        return op.type != OpType::pushClip && op.type != OpType::popClip
+            && op.type != OpType::pushFixed && op.type != OpType::popFixed;
+    }
+
+    static bool isFill (const Op& op)
+    {
+        return op.type == OpType::fillRect || op.type == OpType::fillPath;
+    }
+
+    void dropInvisibleFills()
+    {
+        ops.erase (std::remove_if (ops.begin(), ops.end(), [] (const Op& op) {
+            return isFill (op) && (op.colour.isTransparent() || op.bounds.isEmpty());
+        }), ops.end());
+    }
+
+    /** Merge consecutive fills of the same colour.
+
+        Rectangles sharing a whole edge become one rectangle. Opaque paths
+        (borders) not overlapping get appended into a single path, as
+        overlapping ones would be blended once instead of twice, or cancel
+        each other out with the non-zero winding rule.
+     */
+    void mergeFills()
+    {
+        std::vector<Op> merged;
+        merged.reserve (ops.size());
+
+        for (const auto& op : ops)
+        {
+            if (! merged.empty())
+            {
+                auto& prev { merged.back() };
+
+                if (prev.type == op.type && prev.colour == op.colour)
+                {
+                    if (op.type == OpType::fillRect && shareEdge (prev.bounds, op.bounds))
+                    {
+                        prev.bounds = prev.bounds.getUnion (op.bounds);
+                        continue;
+                    }
+
+                    if (op.type == OpType::fillPath && op.colour.isOpaque()
+                        && ! prev.bounds.intersects (op.bounds))
+                    {
+                        paths[(size_t) prev.index].addPath (paths[(size_t) op.index]);
+                        paths[(size_t) op.index].clear();
+                        prev.bounds = prev.bounds.getUnion (op.bounds);
+                        continue;
+                    }
+                }
+            }
+
+            merged.push_back (op);
+        }
+
+        ops = std::move (merged);
+    }
+
+    static bool shareEdge (const Rectangle<float>& a, const Rectangle<float>& b)
+    {
+        if (a.getX() == b.getX() && a.getWidth() == b.getWidth())
+            return a.getBottom() == b.getY() || b.getBottom() == a.getY();
+
+        if (a.getY() == b.getY() && a.getHeight() == b.getHeight())
+            return a.getRight() == b.getX() || b.getRight() == a.getX();
+
+        return false;
+    }
+
+    /** Remove the clips that do not clip anything.
+
+        This drops the clips with nothing drawn in between, as well
+        as the clips containing everything drawn inside them. The clips
+        around fixed boxes are kept, as those move when scrolled.
+     */
+    void elideClips()
+    {
+        struct Scope
+        {
+            size_t push;
+            Rectangle<float> content;
+            bool hasFixed { false };
+        };
+
+        std::vector<Scope> scopes;
+        std::vector<bool> removed (ops.size(), false);
+
+        for (size_t i = 0; i < ops.size(); ++i)
+        {
+            const auto& op { ops[i] };
+
+            if (op.type == OpType::pushClip)
+            {
+                scopes.push_back ({ i, {} });
+            }
+            else if (op.type == OpType::pushFixed)
+            {
+                if (! scopes.empty())
+                    scopes.back().hasFixed = true;
+            }
+            else if (op.type == OpType::popClip)
+            {
+                if (scopes.empty())
+                    continue;
+
+                const auto scope { scopes.back() };
+                scopes.pop_back();
+
+                const auto& clip { ops[scope.push].bounds };
+                const bool redundant { ! scope.hasFixed && (scope.content.isEmpty() || clip.contains (scope.content)) };
+
+                if (redundant)
+                {
+                    removed[scope.push] = true;
+                    removed[i] = true;
+                }
+
+                if (! scopes.empty() && scope.hasFixed)
+                    scopes.back().hasFixed = true;
+
+                // What is left visible counts for the enclosing clip
+                if (! scopes.empty() && ! scope.content.isEmpty())
+                {
+                    const auto content { redundant ? scope.content : scope.content.getIntersection (clip) };
+                    scopes.back().content = scopes.back().content.getUnion (content);
+                }
+            }
+            else if (! scopes.empty() && isDrawing (op))
+            {
+                scopes.back().content = scopes.back().content.getUnion (op.bounds);
+            }
+        }
+
+        size_t n { 0 };
+
+        for (size_t i = 0; i < ops.size(); ++i)
+        {
+            if (! removed[i])
+                ops[n++] = ops[i];
+        }
+
+        ops.resize (n);
+    }
+
+    void matchClips()
+    {
+        std::vector<size_t> pushes;
+
+        for (size_t i = 0; i < ops.size(); ++i)
+        {
+            if (ops[i].type == OpType::pushClip)
+            {
+                pushes.push_back (i);
+            }
+            else if (ops[i].type == OpType::popClip && ! pushes.empty())
+            {
+                ops[pushes.back()].index = (int) i;
+                pushes.pop_back();
+            }
+        }
+    }
+
+    std::vector<Op> ops;
+    std::vector<Path> paths;
+    std::vector<Glyphs> glyphs;
+    std::vector<ImageItem> images;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DisplayList)
+};
+
+} // namespace juce_litehtml
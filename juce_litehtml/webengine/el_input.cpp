@@ -9,8 +9,8 @@ void el_input::parse_attributes()
 {
     const String type { get_attr("type") };
 
-    const auto colour = webColour (get_color ("color", true, get_document()->get_def_color()));
-    auto bgColour = webColour (get_color ("background-color", true, litehtml::web_color(255, 255, 255, 255)));
+    const auto colour = webColour (get_color (litehtml::css_property_color, true, get_document()->get_def_color()));
+    auto bgColour = webColour (get_color (litehtml::css_property_background_color, true, litehtml::web_color(255, 255, 255, 255)));
 
     if (auto* bg { get_background(true) })
         bgColour = webColour (bg->m_color);
@@ -59,14 +59,14 @@ int el_input::render (int x, int y, int max_width, bool second_pass)
 
 void el_input::draw (litehtml::uint_ptr hdc, int x, int y, const litehtml::position* clip)
 {
-    if (component != nullptr)
-    {
-        position pos { m_pos };
-        pos.x += x;
-        pos.y += y;
+    // The document drawing gets recorded and replayed later,
+    // so the view positions the component when painting.
+}
 
-        component->setBounds(pos.x, pos.y, pos.width, pos.height);
-    }
+void el_input::placeComponent (int x, int y)
+{
+    if (component != nullptr)
+        component->setBounds (x, y, m_pos.width, m_pos.height);
 }
 
 } // namespace juce_litehtml
@@ -9,6 +9,9 @@ public:
     int render (int x, int y, int max_width, bool second_pass = false) override;
     void draw (litehtml::uint_ptr hdc, int x, int y, const litehtml::position* clip) override;
 
+    /** Position the input component in the view coordinates. */
+    void placeComponent (int x, int y);
+
 private:
     juce::Component* component { nullptr };
     std::unique_ptr<juce::TextEditor> textEditor { nullptr };
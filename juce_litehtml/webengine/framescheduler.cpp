@@ -0,0 +1,122 @@
+namespace juce_litehtml {
+
+/** Coalesces the view update requests.
+
+    The requests only mark the view dirty, recording the reason.
+    The update is then performed at most once per display frame
+    with all the reasons requested since the previous update.
+
+    Frames are driven by the vertical blank of the display showing the
+    view. A view without a peer falls back to a timer. Either one is
+    only active while there are updates pending.
+*/
+class FrameScheduler final : private Timer,
+                             private AsyncUpdater
+{
+public:
+
+    /** Frame update callback.
+
+        This gets the merged update reasons and the number of requests
+        coalesced into the frame. It is called on the message thread.
+     */
+    using Callback = std::function<void (int reasons, int numRequests)>;
+
+    FrameScheduler (Component& viewToSync, Callback frameCallback, int fallbackFramesPerSecond = 60)
+        : view { viewToSync },
+          callback { std::move (frameCallback) },
+          frameRate { fallbackFramesPerSecond }
+    {
+        jassert (callback != nullptr);
+        jassert (frameRate > 0);
+    }
+
+    ~FrameScheduler()
+    {
+        vBlank.reset();
+        stopTimer();
+        cancelPendingUpdate();
+    }
+
+    /** Request an update with the given reason.
+
+        This can be called from any thread.
+     */
+    void schedule (int reason)
+    {
+        pendingReasons.fetch_or (reason);
+        ++pendingRequests;
+
+        if (MessageManager::existsAndIsCurrentThread())
+            startFrames();
+        else
+            triggerAsyncUpdate();
+    }
+
+    /** Perform the pending update right away.
+
+        @returns false if there was nothing to update.
+     */
+    bool flush()
+    {
+        const int reasons { pendingReasons.exchange (0) };
+        const int numRequests { pendingRequests.exchange (0) };
+
+        if (reasons == 0)
+            return false;
+
+        callback (reasons, numRequests);
+        return true;
+    }
+
+    int getPendingReasons() const noexcept { return pendingReasons.load(); }
+
+private:
+
+    void startFrames()
+    {
+        if (vBlank != nullptr || isTimerRunning())
+            return;
+
+        if (view.getPeer() != nullptr)
+            vBlank = std::make_unique<VBlankAttachment> (&view, [this] { vBlankCallback(); });
+        else
+            startTimerHz (frameRate);
+    }
+
+    void vBlankCallback()
+    {
+        // The attachment cannot be destroyed from its own callback,
+        // so it gets detached asynchronously once idle.
+        if (! flush())
+            triggerAsyncUpdate();
+    }
+
+    void timerCallback() override
+    {
+        // Stop ticking once there is nothing left to update
+        if (! flush())
+            stopTimer();
+    }
+
+    void handleAsyncUpdate() override
+    {
+        if (pendingReasons.load() != 0)
+            startFrames();
+        else
+            vBlank.reset();
+    }
+
+    Component& view;
+    Callback callback;
+    const int frameRate;
+
+    std::atomic<int> pendingReasons { 0 };
+    std::atomic<int> pendingRequests { 0 };
+
+    std::unique_ptr<VBlankAttachment> vBlank;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FrameScheduler)
+};
+
+} // namespace juce_litehtml
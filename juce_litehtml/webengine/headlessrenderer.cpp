@@ -0,0 +1,209 @@
+namespace juce_litehtml {
+
+struct HeadlessRenderer::Impl
+{
+    WebLoader& loader;
+    Renderer renderer;
+    litehtml::context context;
+
+    litehtml::document::ptr document;
+    std::shared_ptr<const DisplayList> displayList;
+
+    int width;
+    int height;
+    float scale;
+
+    Impl (WebLoader& ldr, int w, int h, float s)
+        : loader { ldr },
+          width { w },
+          height { h },
+          scale { s }
+    {
+        // No custom elements, the scripts and the controls
+        // need the message loop.
+        context.set_master_stylesheet (WebContext::getMasterStylesheet());
+        context.set_use_arena (true);
+
+        renderer.setLoader (&loader);
+        renderer.setSynchronousLoads (true);
+        renderer.setViewportSize (width, height);
+        updateDisplayMetrics();
+    }
+
+    void updateDisplayMetrics()
+    {
+        // The scale only affects the images resolution,
+        // the layout is done in 96 dpi logical pixels.
+        if (renderer.setDisplayMetrics (96.0 * scale, scale, { 0, 0, width, height }))
+            displayList.reset();
+    }
+
+    void setScale (float s)
+    {
+        scale = s;
+        updateDisplayMetrics();
+    }
+
+    void setViewportSize (int w, int h)
+    {
+        if (w == width && h == height)
+            return;
+
+        width = w;
+        height = h;
+        renderer.setViewportSize (width, height);
+        updateDisplayMetrics();
+
+        if (document != nullptr)
+        {
+            document->media_changed();
+            render();
+        }
+    }
+
+    void loadFromHTML (const String& html)
+    {
+        displayList.reset();
+        renderer.clearTextRuns();
+        renderer.clearImages();
+
+        document = litehtml::document::createFromUTF8 (html.toRawUTF8(), &renderer, &context);
+        render();
+    }
+
+    void render()
+    {
+        if (document == nullptr)
+            return;
+
+        renderer.clearTextRuns();
+        displayList.reset();
+
+        document->render (width, litehtml::render_all);
+
+        // There is no scrolling, so all the lazy images are loaded
+        if (document->has_lazy_images())
+        {
+            const auto bounds { getDocumentBounds() };
+
+            if (document->load_lazy_images ({ 0, 0, bounds.getWidth(), bounds.getHeight() }))
+                document->render (width, litehtml::render_all);
+        }
+    }
+
+    Rectangle<int> getDocumentBounds() const
+    {
+        if (document == nullptr)
+            return { 0, 0, width, height };
+
+        return { 0, 0, jmax (width, document->width()), jmax (height, document->height()) };
+    }
+
+    void paint (Graphics& g, const Rectangle<int>& area)
+    {
+        // @todo Get the colour from <body> style
+        g.setColour (Colours::white);
+        g.fillRect (0, 0, area.getWidth(), area.getHeight());
+
+        if (document == nullptr)
+            return;
+
+        if (displayList == nullptr)
+        {
+            // Fixed boxes are drawn at the viewport top-left corner
+            auto list { std::make_shared<DisplayList>() };
+            document->draw ((litehtml::uint_ptr) list.get(), 0, 0, nullptr, litehtml::render_all);
+            list->optimise();
+
+            displayList = std::move (list);
+        }
+
+        displayList->replay (g, area);
+    }
+};
+
+//==============================================================================
+
+HeadlessRenderer::HeadlessRenderer (WebLoader& loader, int viewportWidth, int viewportHeight, float scale)
+    : d { std::make_unique<Impl> (loader, viewportWidth, viewportHeight, scale) }
+{
+    jassert (scale > 0.0f);
+}
+
+HeadlessRenderer::~HeadlessRenderer() = default;
+
+void HeadlessRenderer::setViewportSize (int width, int height)
+{
+    d->setViewportSize (width, height);
+}
+
+Rectangle<int> HeadlessRenderer::getViewport() const
+{
+    return { 0, 0, d->width, d->height };
+}
+
+void HeadlessRenderer::setScale (float scale)
+{
+    jassert (scale > 0.0f);
+    d->setScale (scale);
+}
+
+float HeadlessRenderer::getScale() const
+{
+    return d->scale;
+}
+
+bool HeadlessRenderer::loadFromURL (const URL& url)
+{
+    const auto fixedUrl { d->loader.fixUpURL (url) };
+    d->loader.setBaseURL (fixedUrl);
+
+    const auto html { d->loader.loadTextSync (fixedUrl) };
+
+    if (html.isEmpty())
+        return false;
+
+    d->loadFromHTML (html);
+    return true;
+}
+
+void HeadlessRenderer::loadFromHTML (const String& html)
+{
+    d->loadFromHTML (html);
+}
+
+litehtml::document::ptr HeadlessRenderer::getDocument()
+{
+    return d->document;
+}
+
+Rectangle<int> HeadlessRenderer::getDocumentBounds() const
+{
+    return d->getDocumentBounds();
+}
+
+Image HeadlessRenderer::paint (const Rectangle<int>& area)
+{
+    Image image (Image::ARGB,
+                 jmax (1, roundToInt (area.getWidth() * d->scale)),
+                 jmax (1, roundToInt (area.getHeight() * d->scale)),
+                 true,
+                 SoftwareImageType());
+
+    {
+        Graphics g (image);
+        g.addTransform (AffineTransform::scale (d->scale));
+        d->paint (g, area);
+    }
+
+    return image;
+}
+
+void HeadlessRenderer::paint (Graphics& g, const Rectangle<int>& area)
+{
+    Graphics::ScopedSaveState state (g);
+    g.reduceClipRegion (0, 0, area.getWidth(), area.getHeight());
+    d->paint (g, area);
+}
+
+} // namespace juce_litehtml
@@ -0,0 +1,71 @@
+#pragma once
+
+namespace juce_litehtml {
+
+/** Off-screen document renderer.
+
+    This lays out a document for a given viewport size and paints
+    any region of it into an image, with no component or message
+    loop involved. It can be used to generate thumbnails and
+    previews, or to benchmark the layout and the painting.
+
+    All the document resources are loaded synchronously on the calling
+    thread, so the document is complete as soon as it has been loaded.
+    The scripts are not executed and the form controls are not created.
+*/
+class HeadlessRenderer final
+{
+public:
+
+    /** Create a renderer.
+
+        @param loader           Loader used to fetch the document resources.
+        @param viewportWidth    Width the document gets laid out to.
+        @param viewportHeight   Height of the viewport used by the media queries
+                                and the fixed boxes.
+        @param scale            Scale of the painted images pixels.
+     */
+    HeadlessRenderer (WebLoader& loader, int viewportWidth, int viewportHeight, float scale = 1.0f);
+    ~HeadlessRenderer();
+
+    void setViewportSize (int width, int height);
+    juce::Rectangle<int> getViewport() const;
+
+    void setScale (float scale);
+    float getScale() const;
+
+    /** Load the document from URL synchronously.
+
+        @returns false if the document could not be loaded.
+     */
+    bool loadFromURL (const juce::URL& url);
+
+    /** Load the document from an HTML string. */
+    void loadFromHTML (const juce::String& html);
+
+    /** Returns the loaded document, laid out to the viewport width. */
+    litehtml::document::ptr getDocument();
+
+    /** Returns the area covered by the laid out document.
+
+        This is at least as large as the viewport.
+     */
+    juce::Rectangle<int> getDocumentBounds() const;
+
+    /** Paint the document area into a new image.
+
+        The image size is the area size multiplied by the scale.
+     */
+    juce::Image paint (const juce::Rectangle<int>& area);
+
+    /** Paint the document area at the graphics context origin. */
+    void paint (juce::Graphics& g, const juce::Rectangle<int>& area);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> d;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HeadlessRenderer)
+};
+
+} // namespace juce_litehtml
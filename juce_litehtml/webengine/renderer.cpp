@@ -0,0 +1,778 @@
+namespace juce_litehtml {
+
+using namespace litehtml;
+
+/** Document container recording the document drawing.
+
+    The drawing callbacks expect a DisplayList as the device context,
+    the recorded list is then replayed to the actual graphics context.
+
+    The renderer does not depend on a view: the viewport size, the display
+    metrics and the resources loader are all injected, so it is shared by
+    the WebView and the HeadlessRenderer.
+*/
+class Renderer final : public litehtml::document_container
+{
+public:
+    Renderer() = default;
+
+    uint_ptr create_font (const tchar_t* faceName,
+                          int size,
+                          int weight,
+                          font_style style,
+                          unsigned int decoration,
+                          font_metrics* fm) override
+    {
+        String fontName { juceString (faceName) };
+        int styleFlags { Font::plain };
+
+        if (decoration & font_decoration_underline)
+            styleFlags |= Font::underlined;
+        if (style == litehtml::fontStyleItalic)
+            styleFlags |= Font::italic;
+        if (weight >= 500)
+            styleFlags |= Font::bold;
+
+        auto font { std::make_unique<Font> (fontName, (float) size, styleFlags) };
+
+        if (fm != nullptr)
+        {
+            fm->ascent = (int)font->getAscent();
+            fm->descent = (int)font->getDescent();
+            fm->height = (int)font->getHeight();
+            fm->x_height = fm->height;  // 'x' character height
+            fm->draw_spaces = (style == litehtml::fontStyleItalic || decoration != 0);
+        }
+
+        return (uint_ptr) font.release();
+    }
+
+    void delete_font (uint_ptr hFont) override
+    {
+        textWidthCache.removeFont (hFont);
+
+        auto* font { static_cast<Font*>((void*) hFont) };
+        delete font;
+    }
+
+    int text_width (const tchar_t* text, uint_ptr hFont) override
+    {
+        if (auto* font { static_cast<Font*>((void*) hFont) })
+            return textWidthCache.getWidth (hFont, text, [font] (const tchar_t* t) { return font->getStringWidth (juceString (t)); });
+
+        return 0;
+    }
+
+    void text_widths (const tchar_t* const* texts, size_t count, uint_ptr hFont, int* widths) override
+    {
+        if (auto* font { static_cast<Font*>((void*) hFont) })
+        {
+            textWidthCache.getWidths (hFont, texts, count, widths, [font] (const tchar_t* t) { return font->getStringWidth (juceString (t)); });
+            return;
+        }
+
+        std::fill (widths, widths + count, 0);
+    }
+
+    void draw_text (uint_ptr hdc, const tchar_t* text, uint_ptr hFont, web_color color, const position& pos) override
+    {
+        auto* list { static_cast<DisplayList*> ((void*) hdc) };
+        auto* font { static_cast<Font*> ((void*) hFont) };
+
+        if (list == nullptr || font == nullptr)
+            return;
+
+        // Same as Graphics::drawText with the left justification
+        auto glyphs { std::make_shared<GlyphArrangement>() };
+        glyphs->addCurtailedLineOfText (*font, juceString (text), 0.0f, 0.0f, (float) pos.width, true);
+        glyphs->justifyGlyphs (0, glyphs->getNumGlyphs(),
+                               (float) pos.x, (float) pos.y, (float) pos.width, (float) pos.height,
+                               Justification::left);
+
+        list->drawGlyphs (std::move (glyphs), {}, webColour (color));
+    }
+
+    void draw_text_run (uint_ptr hdc, const text_run& run, uint_ptr hFont, web_color color, const position& pos) override
+    {
+        auto* list { static_cast<DisplayList*> ((void*) hdc) };
+        auto* font { static_cast<Font*> ((void*) hFont) };
+
+        if (list == nullptr || font == nullptr)
+            return;
+
+        list->drawGlyphs (getTextRunGlyphs (run, *font, hFont), { (float) pos.x, (float) pos.y }, webColour (color));
+    }
+
+    int pt_to_px (int pt) const override
+    {
+        return (int) (displayMetrics.dpi * pt / 72.0 / displayMetrics.scale);
+    }
+
+    int get_default_font_size() const override
+    {
+        return 16;
+    }
+
+    const tchar_t* get_default_font_name() const override
+    {
+        return _t("Tahoma");
+    }
+
+    void draw_list_marker (uint_ptr hdc, const list_marker& marker) override
+    {
+        if (auto* list { static_cast<DisplayList*> ((void*) hdc) })
+        {
+            const auto& pos { marker.pos };
+            const Rectangle<int> area (pos.x, pos.y, pos.width, pos.height);
+            const auto colour { webColour (marker.color) };
+
+            switch (marker.marker_type)
+            {
+                case list_style_type_none:
+                    break;
+                case list_style_type_circle:
+                    list->drawEllipse (area.toFloat(), colour);
+                    break;
+                case list_style_type_disc:
+                    list->fillEllipse (area.toFloat(), colour);
+                    break;
+                case list_style_type_square:
+                    list->fillRect (area, colour);
+                    break;
+                default:
+                    list->drawRect (area.toFloat(), colour);
+                    break;
+            }
+        }
+    }
+
+    void load_image (const tchar_t* src, const tchar_t* baseurl, bool redraw_on_ready) override
+    {
+        auto* loader { getLoader() };
+
+        if (loader == nullptr)
+            return;
+
+        const auto image { getImageHandle (src) };
+
+        {
+            const ScopedLock sl (imagesLock);
+
+            image->redrawOnReady = image->redrawOnReady || redraw_on_ready;
+
+            // Each image is only requested once
+            if (image->state == ImageHandle::State::loading || image->state == ImageHandle::State::loaded)
+                return;
+
+            image->state = ImageHandle::State::loading;
+        }
+
+        if (synchronousLoads)
+        {
+            setImageLoaded (*image, loader->loadImageSync (image->url));
+            return;
+        }
+
+        loader->loadAsync<Image> (image->url, [this, image](bool ok, const Image& content) {
+            if (setImageLoaded (*image, ok ? content : Image()) && imageLoaded)
+                imageLoaded();
+        });
+    }
+
+    void get_image_size (const tchar_t* src, const tchar_t* baseurl, litehtml::size& sz) override
+    {
+        get_resolved_image_size ((uint_ptr) getImageHandle (src).get(), sz);
+    }
+
+    uint_ptr resolve_image (const tchar_t* src, const tchar_t* baseurl) override
+    {
+        return (uint_ptr) getImageHandle (src).get();
+    }
+
+    void get_resolved_image_size (uint_ptr hImage, litehtml::size& sz) override
+    {
+        sz.width = 0;
+        sz.height = 0;
+
+        auto* image { static_cast<ImageHandle*> ((void*) hImage) };
+
+        if (image == nullptr)
+            return;
+
+        {
+            const ScopedLock sl (imagesLock);
+
+            if (image->hasSize)
+            {
+                sz.width = image->width;
+                sz.height = image->height;
+                return;
+            }
+        }
+
+        auto* loader { getLoader() };
+
+        if (loader == nullptr)
+            return;
+
+        int width{};
+        int height{};
+
+        // Image has not been loaded yet, read its size from the header
+        if (! loader->probeImageSize (image->url, width, height))
+        {
+            // Unknown format, force local load
+            Image content{};
+
+            if (! loader->loadLocal (image->url, content) || content.isNull())
+                return;
+
+            width = content.getWidth();
+            height = content.getHeight();
+        }
+
+        const ScopedLock sl (imagesLock);
+
+        image->hasSize = true;
+        image->width = width;
+        image->height = height;
+
+        sz.width = width;
+        sz.height = height;
+    }
+
+    void draw_background (uint_ptr hdc, const background_paint &bg) override
+    {
+        if (auto* list { static_cast<DisplayList*> ((void*) hdc) })
+        {
+            if (bg.image.empty())
+            {
+                Rectangle<int> rect;
+                rect.setX (bg.position_x + bg.clip_box.left());
+                rect.setY (bg.position_y + bg.clip_box.top());
+                rect.setWidth (bg.clip_box.width);
+                rect.setHeight (bg.clip_box.height);
+
+                list->fillRect (rect, webColour (bg.color));
+            }
+            else if (auto* loader { getLoader() })
+            {
+                // The images resolved when parsing the styles are drawn
+                // with no string or URL work
+                const auto handle { bg.image_handle != 0 ? static_cast<ImageHandle*> ((void*) bg.image_handle)
+                                                         : getImageHandle (bg.image.c_str()).get() };
+
+                if (handle->state == ImageHandle::State::failed)
+                    return;
+
+                // @todo handle background paint correctly
+                Rectangle<float> frect;
+                frect.setLeft (bg.position_x);
+                frect.setTop (bg.position_y);
+                frect.setWidth (bg.clip_box.width);
+                frect.setHeight (bg.clip_box.height);
+
+                // Only the pixels actually shown get decoded and kept
+                const auto displayed { bg.image_size.width > 0 && bg.image_size.height > 0
+                                           ? Rectangle<float> ((float) bg.image_size.width, (float) bg.image_size.height)
+                                           : frect };
+
+                const auto scale { (float) displayMetrics.scale };
+
+                const auto image { scaledImages.getImage (handle->key,
+                                                          roundToInt (jmax (displayed.getWidth(), frect.getWidth()) * scale),
+                                                          roundToInt (jmax (displayed.getHeight(), frect.getHeight()) * scale),
+                                                          [loader, handle] {
+                                                              Image full;
+                                                              loader->loadLocalOrCached<Image> (handle->url, full);
+                                                              return full;
+                                                          }) };
+
+                if (! image.isNull())
+                {
+                    if (bg.repeat == background_repeat_repeat)
+                        list->drawImage (image, frect, RectanglePlacement::fillDestination);
+                    else
+                        list->drawImage (image, frect, RectanglePlacement::stretchToFit);
+                }
+            }
+        }
+    }
+
+    void draw_borders (uint_ptr hdc, const borders& borders, const position& draw_pos, [[maybe_unused]] bool root) override
+    {
+        if (auto* list { static_cast<DisplayList*> ((void*) hdc) })
+        {
+            int bdr_top { 0 };
+            int bdr_bottom { 0 };
+            int bdr_left { 0 };
+            int bdr_right { 0 };
+
+            if (borders.top.width > 0 && borders.top.style > border_style_hidden)
+                bdr_top = borders.top.width;
+
+            if (borders.bottom.width > 0 && borders.bottom.style > border_style_hidden)
+                bdr_bottom = borders.bottom.width;
+
+            if (borders.left.width > 0 && borders.left.style > border_style_hidden)
+                bdr_left = borders.left.width;
+
+            if (borders.right.width > 0 && borders.right.style > border_style_hidden)
+                bdr_right = borders.right.width;
+
+            // @todo Draw rounded boxes
+
+            const auto left { (float) draw_pos.left() };
+            const auto top { (float) draw_pos.top() };
+            const auto right { (float) draw_pos.right() };
+            const auto bottom { (float) draw_pos.bottom() };
+
+            // One pixel lines centred on the box edges, the sides
+            // of the same colour are filled as a single path.
+            struct Side
+            {
+                bool visible;
+                web_color color;
+                Rectangle<float> line;
+            };
+
+            const Side sides[] {
+                { bdr_top != 0,    borders.top.color,    { left, top - 0.5f, right - left, 1.0f } },
+                { bdr_bottom != 0, borders.bottom.color, { left, bottom - 0.5f, right - left, 1.0f } },
+                { bdr_left != 0,   borders.left.color,   { left - 0.5f, top, 1.0f, bottom - top } },
+                { bdr_right != 0,  borders.right.color,  { right - 0.5f, top, 1.0f, bottom - top } }
+            };
+
+            bool added[4] { false, false, false, false };
+
+            for (int i = 0; i < 4; ++i)
+            {
+                if (! sides[i].visible || added[i])
+                    continue;
+
+                const auto colour { webColour (sides[i].color) };
+                Path path;
+
+                for (int j = i; j < 4; ++j)
+                {
+                    if (sides[j].visible && ! added[j] && webColour (sides[j].color) == colour)
+                    {
+                        path.addRectangle (sides[j].line);
+                        added[j] = true;
+                    }
+                }
+
+                list->fillPath (std::move (path), colour);
+            }
+        }
+    }
+
+    void set_caption (const tchar_t* caption) override
+    {
+       // @todo Notify caption changed
+    }
+
+    void set_base_url (const tchar_t* base_url) override
+    {
+        if (auto* loader { getLoader() })
+        {
+            const String sUrl (juceString (base_url));
+            loader->setBaseURL (sUrl);
+        }
+    }
+
+    void link (const std::shared_ptr<litehtml::document>& doc, const litehtml::element::ptr& el) override
+    {
+        // @todo
+        // Called when el_link element gets parsed
+    }
+
+    void on_anchor_click (const tchar_t* turl, const litehtml::element::ptr& el) override
+    {
+        if (followLink)
+        {
+            const URL url (juceString (turl));
+            followLink (url);
+        }
+    }
+
+    void set_cursor (const tchar_t* cursor) override
+    {
+        static std::map<String, MouseCursor::StandardCursorType> cursorTypes
+        {
+            { "none",       MouseCursor::NoCursor           },
+            { "auto",       MouseCursor::ParentCursor       },
+            { "pointer",    MouseCursor::PointingHandCursor },
+            { "crosshair",  MouseCursor::CrosshairCursor    }
+        };
+
+        auto cur { MouseCursor::NormalCursor };
+        const String cursorName { juceString (cursor).toLowerCase().trim() };
+
+        if (const auto it { cursorTypes.find (cursorName) }; it != cursorTypes.end())
+            cur = it->second;
+
+        // @todo Updaye mouse cursor
+        // webView.setMouseCursor (cur);
+    }
+
+    void transform_text (litehtml::tstring& text, litehtml::text_transform tt) override
+    {
+        String str { juceString (text.c_str()) };
+
+        switch (tt)
+        {
+            case text_transform::text_transform_uppercase:
+                str = str.toUpperCase();
+                break;
+            case text_transform::text_transform_lowercase:
+                str = str.toLowerCase();
+                break;
+            case text_transform::text_transform_capitalize:
+                if (str.isNotEmpty())
+                {
+                    str = str.substring (0,1).toUpperCase() + str.substring (1, str.length() - 1);
+                }
+            case text_transform::text_transform_none:
+            default:
+                break;
+        }
+
+    #ifdef LITEHTML_UTF8
+        text = litehtml::tstring (str.toStdString());
+    #else
+        text = litehtml::tstring (str.toWideCharPointer());
+    #endif
+    }
+
+    void import_css (tstring& text, const tstring& tsurl, tstring& baseurl) override
+    {
+        if (auto* loader { getLoader() })
+        {
+            const URL url (juceString (tsurl));
+            const String content { loader->loadTextSync (url) };
+
+            text = to_tstring (content);
+        }
+    }
+
+    void import_script (tstring& text, const tstring& tsurl) override
+    {
+        if (auto* loader { getLoader() })
+        {
+            const URL url (juceString (tsurl));
+            const String content { loader->loadTextSync (url) };
+
+            text = to_tstring (content);
+        }
+    }
+
+    void set_clip (litehtml::uint_ptr hdc, const position &pos, const border_radiuses &bdr_radius, bool valid_x, bool valid_y) override
+    {
+        if (auto* list { static_cast<DisplayList*> ((void*) hdc) })
+        {
+            // The graphics clip is not known when recording,
+            // so the axis not being clipped is left unbounded.
+            constexpr int unbounded { 1 << 24 };
+
+            list->pushClip ({ valid_x ? pos.x : -unbounded,
+                              valid_y ? pos.y : -unbounded,
+                              valid_x ? pos.width : 2 * unbounded,
+                              valid_y ? pos.height : 2 * unbounded });
+        }
+    }
+
+    void del_clip(litehtml::uint_ptr hdc) override
+    {
+        if (auto* list { static_cast<DisplayList*> ((void*) hdc) })
+        {
+            list->popClip();
+        }
+    }
+
+    void begin_fixed (litehtml::uint_ptr hdc) override
+    {
+        if (auto* list { static_cast<DisplayList*> ((void*) hdc) })
+            list->pushFixed();
+    }
+
+    void end_fixed (litehtml::uint_ptr hdc) override
+    {
+        if (auto* list { static_cast<DisplayList*> ((void*) hdc) })
+            list->popFixed();
+    }
+
+    void get_client_rect (position& client) const override
+    {
+        client.x = 0;
+        client.y = 0;
+        client.width = viewportWidth;
+        client.height = viewportHeight;
+    }
+
+    litehtml::element::ptr create_element (const litehtml::tchar_t *tag_name,
+                                           const litehtml::string_map &attributes,
+                                           const litehtml::document::ptr& doc) override
+    {
+        if (context != nullptr)
+            return context->create_element (tag_name, attributes, doc);
+
+        return nullptr;
+    }
+
+    void get_media_features(litehtml::media_features &media) const override
+    {
+        // The viewport is the view itself, not the display
+        media.width = viewportWidth;
+        media.height = viewportHeight;
+        media.resolution = (int) displayMetrics.dpi;
+        media.device_width = displayMetrics.totalArea.getWidth();
+        media.device_height = displayMetrics.totalArea.getHeight();
+
+        media.type = litehtml::media_type_screen;
+        media.color = 8;
+        media.monochrome = 0;
+        media.color_index = 256;
+    }
+
+    void get_language (tstring &language, tstring &culture) const override
+    {
+        language = _t("en");
+        culture = _t("en-GB");
+    }
+
+    bool lazy_load_images() const override
+    {
+        return lazyImages;
+    }
+
+    tstring resolve_color (const tstring &color) const override
+    {
+        String colorName { juceString (color.c_str()) };
+
+        Colour c { Colours::findColourForName (colorName, Colour::fromString (colorName)) };
+        String strColour = String ("#") + c.toDisplayString (true);
+
+    #ifdef LITEHTML_UTF8
+        return litehtml::tstring (strColour.toStdString());
+    #else
+        return litehtml::tstring (strColour.toWideCharPointer());
+    #endif
+    }
+
+    /** Release the glyphs cached for the text runs.
+
+        The runs get rebuilt by the document layout, so this should
+        be called whenever the document is rendered again.
+     */
+    void clearTextRuns()
+    {
+        const ScopedLock sl (textRunsLock);
+        textRuns.clear();
+    }
+
+    /** Release the image handles of the replaced document.
+
+        The handles are keyed by their absolute URL, so the same relative
+        reference on another page gets a new handle. The released handles
+        are kept until the next call, as the replaced document can still
+        be drawn until the new one gets created.
+     */
+    void clearImages()
+    {
+        {
+            const ScopedLock sl (imagesLock);
+
+            retiredImages.clear();
+
+            for (auto& it : images)
+                retiredImages.push_back (std::move (it.second));
+
+            images.clear();
+        }
+
+        scaledImages.clear();
+    }
+
+    /** Assign the loader used to fetch the document resources. */
+    void setLoader (WebLoader* newLoader) { loader = newLoader; }
+
+    /** Assign the context creating the custom elements.
+
+        With no context the documents get only the standard elements.
+     */
+    void setContext (WebContext* newContext) { context = newContext; }
+
+    /** Set the size reported as the client area and media viewport. */
+    void setViewportSize (int width, int height)
+    {
+        viewportWidth = width;
+        viewportHeight = height;
+    }
+
+    /** Load the images on the calling thread.
+
+        By default the images are loaded asynchronously and imageLoaded
+        gets called once they arrive, which needs the message loop running.
+        With synchronous loads the images are ready as soon as the document
+        gets created.
+     */
+    void setSynchronousLoads (bool shouldLoadSynchronously) { synchronousLoads = shouldLoadSynchronously; }
+
+    /** Defer loading all the images until they get near the viewport. */
+    void setLazyImages (bool shouldLoadLazily) { lazyImages = shouldLoadLazily; }
+
+    /** Set the metrics of the display the document is shown on.
+
+        The display metrics are only taken here rather than queried
+        on every pt_to_px or media features request.
+
+        @returns true if the metrics have changed.
+     */
+    bool setDisplayMetrics (double dpi, double scale, const Rectangle<int>& totalArea)
+    {
+        const DisplayMetrics metrics { dpi, scale, totalArea };
+
+        if (metrics == displayMetrics)
+            return false;
+
+        displayMetrics = metrics;
+        return true;
+    }
+
+    // Callbacks
+
+    std::function<void (const URL&)> followLink{};
+    std::function<void()> imageLoaded{};
+
+private:
+
+    struct DisplayMetrics
+    {
+        double dpi { 96.0 };
+        double scale { 1.0 };
+        Rectangle<int> totalArea { 0, 0, 1024, 768 };
+
+        bool operator== (const DisplayMetrics& other) const
+        {
+            return dpi == other.dpi && scale == other.scale && totalArea == other.totalArea;
+        }
+    };
+
+    /** Resolved image reference.
+
+        The image references are resolved once when the document styles
+        get parsed. The handles stay valid until the document gets
+        replaced, see clearImages().
+     */
+    struct ImageHandle
+    {
+        enum class State
+        {
+            unloaded,
+            loading,
+            loaded,
+            failed
+        };
+
+        URL url;
+        size_t key { 0 };       // Scaled images cache key
+        std::atomic<State> state { State::unloaded };   // Read when drawing without the lock
+        bool redrawOnReady { false };
+        bool hasSize { false };
+        int width { 0 };
+        int height { 0 };
+    };
+
+    std::shared_ptr<const GlyphArrangement> getTextRunGlyphs (const text_run& run, const Font& font, uint_ptr hFont)
+    {
+        const TextRunKey key { run.id, hFont };
+
+        {
+            const ScopedLock sl (textRunsLock);
+            const auto it { textRuns.find (key) };
+
+            if (it != textRuns.end())
+                return it->second;
+        }
+
+        // Each word is placed where the layout has put it
+        auto glyphs { std::make_shared<GlyphArrangement>() };
+
+        for (const auto& part : run.parts)
+            glyphs->addLineOfText (font, juceString (part.text), (float) part.x, font.getAscent());
+
+        const ScopedLock sl (textRunsLock);
+        textRuns[key] = glyphs;
+
+        return glyphs;
+    }
+
+    WebLoader* getLoader() { return loader; }
+
+    std::shared_ptr<ImageHandle> getImageHandle (const tchar_t* src)
+    {
+        // Relative references are resolved against the current page
+        const auto url { loader != nullptr ? loader->fixUpURL (URL (juceString (src))) : URL (juceString (src)) };
+        const auto fullUrl { url.toString (true) };
+
+        const ScopedLock sl (imagesLock);
+
+        auto& image { images[to_tstring (fullUrl)] };
+
+        if (image == nullptr)
+        {
+            image = std::make_shared<ImageHandle>();
+            image->url = url;
+            image->key = fullUrl.hash();
+        }
+
+        return image;
+    }
+
+    /** Record the loaded image.
+
+        @returns true if the document asked to be redrawn once it is loaded.
+     */
+    bool setImageLoaded (ImageHandle& image, const Image& content)
+    {
+        const ScopedLock sl (imagesLock);
+
+        if (content.isNull())
+        {
+            image.state = ImageHandle::State::failed;
+            return false;
+        }
+
+        image.state = ImageHandle::State::loaded;
+        image.hasSize = true;
+        image.width = content.getWidth();
+        image.height = content.getHeight();
+
+        return image.redrawOnReady;
+    }
+
+    WebLoader* loader { nullptr };
+    WebContext* context { nullptr };
+
+    int viewportWidth { 0 };
+    int viewportHeight { 0 };
+    bool synchronousLoads { false };
+    bool lazyImages { false };
+
+    DisplayMetrics displayMetrics;
+
+    CriticalSection imagesLock;
+    std::unordered_map<tstring, std::shared_ptr<ImageHandle>> images;
+    std::vector<std::shared_ptr<ImageHandle>> retiredImages;
+
+    TextWidthCache textWidthCache;
+    ScaledImageCache scaledImages;
+
+    using TextRunKey = std::pair<size_t, uint_ptr>;
+
+    CriticalSection textRunsLock;
+    std::map<TextRunKey, std::shared_ptr<const GlyphArrangement>> textRuns;
+};
+
+} // namespace juce_litehtml
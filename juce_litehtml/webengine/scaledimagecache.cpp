@@ -0,0 +1,159 @@
+namespace juce_litehtml {
+
+/** Cache of the images scaled to their displayed size.
+
+    Large source images are mostly shown much smaller than their
+    full resolution. Rather than keeping the full size image and scaling
+    it on every paint, the cache keeps a copy downsampled to the requested
+    size. The full size image is loaded again only when a larger copy
+    gets requested.
+
+    The decoded pixels are capped per image, and for the whole cache
+    where the least recently used images are discarded first.
+*/
+class ScaledImageCache final
+{
+public:
+
+    ScaledImageCache (int64 maxImagePixels = 4096 * 4096, int64 maxTotalPixels = 8192 * 8192)
+        : maxPixelsPerImage { maxImagePixels },
+          maxPixels { maxTotalPixels }
+    {
+    }
+
+    /** Return the image scaled to the given size.
+
+        The returned image keeps the source aspect ratio and covers
+        the requested size. It may be larger than requested when a larger
+        copy has been cached already, but never larger than the source.
+
+        @param key      Image identifier.
+        @param width    Requested width in pixels.
+        @param height   Requested height in pixels.
+        @param load     Function loading the full size image.
+     */
+    template <typename LoadFunc>
+    Image getImage (size_t key, int width, int height, LoadFunc&& load)
+    {
+        {
+            const ScopedLock sl (lock);
+
+            const auto it { entries.find (key) };
+
+            if (it != entries.end() && it->second.covers (width, height))
+            {
+                it->second.lastUse = ++useCounter;
+                return it->second.image;
+            }
+        }
+
+        // Loading and scaling is done outside the lock
+        const Image source { load() };
+
+        if (source.isNull())
+            return {};
+
+        Entry entry;
+        entry.image = downsample (source, width, height);
+        entry.fullSize = entry.image.getWidth() == source.getWidth() && entry.image.getHeight() == source.getHeight();
+
+        const ScopedLock sl (lock);
+
+        entry.lastUse = ++useCounter;
+
+        auto& slot { entries[key] };
+        totalPixels -= slot.getNumPixels();
+        slot = entry;
+        totalPixels += slot.getNumPixels();
+
+        evict (key);
+
+        return entry.image;
+    }
+
+    void clear()
+    {
+        const ScopedLock sl (lock);
+
+        entries.clear();
+        totalPixels = 0;
+    }
+
+private:
+
+    struct Entry
+    {
+        Image image;
+        bool fullSize { false };
+        uint64 lastUse { 0 };
+
+        int64 getNumPixels() const
+        {
+            return image.isNull() ? 0 : (int64) image.getWidth() * image.getHeight();
+        }
+
+        bool covers (int width, int height) const
+        {
+            return fullSize || (image.getWidth() >= width && image.getHeight() >= height);
+        }
+    };
+
+    Image downsample (const Image& source, int width, int height) const
+    {
+        // The aspect ratio is kept so that the copy can be placed
+        // in any way, and the source never gets upscaled.
+        auto factor { jmin (1.0, jmax ((double) width / source.getWidth(), (double) height / source.getHeight())) };
+
+        const auto pixels { factor * factor * source.getWidth() * source.getHeight() };
+
+        if (pixels > (double) maxPixelsPerImage)
+            factor *= std::sqrt ((double) maxPixelsPerImage / pixels);
+
+        const auto w { factor * source.getWidth() };
+        const auto h { factor * source.getHeight() };
+
+        const int scaledWidth { jmax (1, roundToInt (w)) };
+        const int scaledHeight { jmax (1, roundToInt (h)) };
+
+        if (scaledWidth == source.getWidth() && scaledHeight == source.getHeight())
+            return source;
+
+        return source.rescaled (scaledWidth, scaledHeight, Graphics::highResamplingQuality);
+    }
+
+    /** Drop the least recently used images over the pixel budget.
+
+        The image that has just been added is always kept.
+     */
+    void evict (size_t keep)
+    {
+        while (totalPixels > maxPixels && entries.size() > 1)
+        {
+            auto oldest { entries.end() };
+
+            for (auto it { entries.begin() }; it != entries.end(); ++it)
+            {
+                if (it->first != keep && (oldest == entries.end() || it->second.lastUse < oldest->second.lastUse))
+                    oldest = it;
+            }
+
+            if (oldest == entries.end())
+                break;
+
+            totalPixels -= oldest->second.getNumPixels();
+            entries.erase (oldest);
+        }
+    }
+
+    const int64 maxPixelsPerImage;
+    const int64 maxPixels;
+
+    CriticalSection lock;
+    std::unordered_map<size_t, Entry> entries;
+    int64 totalPixels { 0 };
+    uint64 useCounter { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ScaledImageCache)
+};
+
+} // namespace juce_litehtml
@@ -0,0 +1,178 @@
+namespace juce_litehtml {
+
+/** Cache of measured text widths.
+
+    Widths are keyed by the font handle and the text. Most of the
+    measured strings are words that repeat a lot across the document,
+    so the shaping work is done only once per distinct word and font.
+    The words are interned by the cache: a lookup only hashes the text,
+    it is copied once when its width gets stored.
+
+    The cache is bounded: entries are kept in two generations,
+    when the recent one gets full the older one is discarded.
+    Entries hit in the older generation are promoted back.
+*/
+class TextWidthCache final
+{
+public:
+
+    TextWidthCache (size_t maxEntries = 8192)
+        : generationSize (jmax ((size_t) 1, maxEntries / 2))
+    {
+    }
+
+    /** Return the cached text width or measure it with the given function. */
+    template <typename MeasureFunc>
+    int getWidth (litehtml::uint_ptr font, const litehtml::tchar_t* text, MeasureFunc&& measure)
+    {
+        int width { 0 };
+        getWidths (font, &text, 1, &width, std::forward<MeasureFunc> (measure));
+        return width;
+    }
+
+    /** Return the widths of a batch of texts sharing the font.
+
+        The cache is locked once for the lookups and once for storing
+        the widths measured, each distinct text missing is measured once.
+    */
+    template <typename MeasureFunc>
+    void getWidths (litehtml::uint_ptr font, const litehtml::tchar_t* const* texts, size_t count, int* widths, MeasureFunc&& measure)
+    {
+        std::vector<size_t> missing;
+
+        {
+            const ScopedLock sl (lock);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (! find ({ font, texts[i] }, widths[i]))
+                    missing.push_back (i);
+            }
+        }
+
+        if (missing.empty())
+            return;
+
+        // Measuring is done outside the lock so that other threads are not blocked
+        std::unordered_map<Word, int> measured;
+
+        for (const auto i : missing)
+        {
+            const auto it { measured.find (texts[i]) };
+
+            if (it != measured.end())
+            {
+                widths[i] = it->second;
+            }
+            else
+            {
+                widths[i] = measure (texts[i]);
+                measured.emplace (texts[i], widths[i]);
+            }
+        }
+
+        const ScopedLock sl (lock);
+
+        for (const auto& m : measured)
+            insert ({ font, m.first }, m.second);
+    }
+
+    /** Forget all the widths measured with the given font.
+
+        This must be called when a font is deleted, since its handle
+        can be reused by another font.
+     */
+    void removeFont (litehtml::uint_ptr font)
+    {
+        const ScopedLock sl (lock);
+
+        removeFont (recent, font);
+        removeFont (older, font);
+    }
+
+    void clear()
+    {
+        const ScopedLock sl (lock);
+
+        recent = {};
+        older = {};
+    }
+
+private:
+
+    using Word = std::basic_string_view<litehtml::tchar_t>;
+    using Key = std::pair<litehtml::uint_ptr, Word>;
+
+    struct KeyHash
+    {
+        size_t operator() (const Key& key) const noexcept
+        {
+            return std::hash<Word>() (key.second) ^ std::hash<litehtml::uint_ptr>() (key.first);
+        }
+    };
+
+    /** The keys point to the words interned by the generation. */
+    struct Generation
+    {
+        std::unordered_map<Key, int, KeyHash> widths;
+        std::deque<litehtml::tstring> words;    // Element references stay valid when appending
+    };
+
+    bool find (const Key& key, int& width)
+    {
+        const auto it { recent.widths.find (key) };
+
+        if (it != recent.widths.end())
+        {
+            width = it->second;
+            return true;
+        }
+
+        const auto old { older.widths.find (key) };
+
+        if (old != older.widths.end())
+        {
+            width = old->second;
+            insert (key, width);
+            return true;
+        }
+
+        return false;
+    }
+
+    void insert (const Key& key, int width)
+    {
+        if (recent.widths.count (key) != 0)
+            return;
+
+        if (recent.widths.size() >= generationSize)
+        {
+            older = std::move (recent);
+            recent = {};
+        }
+
+        const auto& word { recent.words.emplace_back (key.second) };
+        recent.widths.emplace (Key { key.first, word }, width);
+    }
+
+    static void removeFont (Generation& generation, litehtml::uint_ptr font)
+    {
+        for (auto it { generation.widths.begin() }; it != generation.widths.end();)
+        {
+            if (it->first.first == font)
+                it = generation.widths.erase (it);
+            else
+                ++it;
+        }
+    }
+
+    const size_t generationSize;
+
+    CriticalSection lock;
+    Generation recent;
+    Generation older;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TextWidthCache)
+};
+
+} // namespace juce_litehtml
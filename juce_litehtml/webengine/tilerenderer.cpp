@@ -0,0 +1,282 @@
+namespace juce_litehtml {
+
+/** Multi-threaded tiled rasteriser.
+
+    The document area covering the visible viewport plus a prefetch
+    margin around it is split into square tiles. Each tile is painted
+    into its own image with a separate software graphics context on
+    a worker thread pool, by replaying the document display list.
+    Painted tiles are retained and reused while scrolling until
+    the document layout changes, call invalidate() then.
+
+    Painting never waits for the workers: the tiles not painted yet are
+    left out, or drawn from their previous content after an invalidation,
+    and onTilePainted gets called as the visible ones complete.
+
+    The workers only get the recorded display list and never the
+    document, which the message thread keeps restyling on mouse
+    events while tiles are being painted.
+*/
+class TileRenderer final : private AsyncUpdater
+{
+public:
+
+    TileRenderer() = default;
+
+    ~TileRenderer() override
+    {
+        setEnabled (false);
+        cancelPendingUpdate();
+    }
+
+    /** Start or stop the worker threads.
+
+        The thread pool only exists while the tiled rendering is used,
+        disabling it drops all the tiles.
+     */
+    void setEnabled (bool shouldBeEnabled)
+    {
+        JUCE_ASSERT_MESSAGE_THREAD
+
+        if (shouldBeEnabled == (pool != nullptr))
+            return;
+
+        if (shouldBeEnabled)
+        {
+            pool = std::make_unique<ThreadPool> (jmax (1, SystemStats::getNumCpus() - 1));
+        }
+        else
+        {
+            clear();
+            pool.reset();
+        }
+    }
+
+    void setTileSize (int size)
+    {
+        jassert (size > 0);
+
+        if (size != tileSize)
+        {
+            clear();
+            tileSize = size;
+        }
+    }
+
+    void setPrefetchMargin (int margin)
+    {
+        prefetchMargin = jmax (0, margin);
+    }
+
+    /** Drop all the painted tiles.
+
+        This waits for the tiles being currently painted to complete.
+        The dropped tiles are still drawn in place of the visible tiles
+        until those get painted again.
+     */
+    void invalidate()
+    {
+        JUCE_ASSERT_MESSAGE_THREAD
+
+        stopWorkers();
+
+        const ScopedLock sl (lock);
+
+        for (auto& [key, tile] : tiles)
+        {
+            if (tile->ready)
+                staleTiles[key] = std::move (tile);
+        }
+
+        tiles.clear();
+    }
+
+    /** Paint the document viewport.
+
+        @param g            Graphics context to paint to.
+        @param list         Recorded document drawing.
+        @param documentArea Area covered by the document.
+        @param viewport     Visible area in the document coordinates.
+                            It will be painted at the graphics context origin.
+
+        @returns the visible area in the document coordinates still being
+                 painted, it needs painting again after onTilePainted.
+     */
+    RectangleList<int> paint (Graphics& g,
+                              const std::shared_ptr<const DisplayList>& list,
+                              const Rectangle<int>& documentArea,
+                              const Rectangle<int>& viewport)
+    {
+        JUCE_ASSERT_MESSAGE_THREAD
+        jassert (list != nullptr);
+        jassert (pool != nullptr);
+
+        const auto scale { g.getInternalContext().getPhysicalPixelScaleFactor() };
+
+        if (scale != tileScale)
+        {
+            clear();
+            tileScale = scale;
+        }
+
+        const auto visibleTiles { getTileRange (viewport.getIntersection (documentArea)) };
+        const auto prefetchTiles { getTileRange (viewport.expanded (prefetchMargin).getIntersection (documentArea)) };
+
+        {
+            const ScopedLock sl (lock);
+
+            visibleRange = visibleTiles;
+
+            // Release the tiles that went out of the prefetch area
+            for (auto it { tiles.begin() }; it != tiles.end();)
+            {
+                if (it->second->ready && ! prefetchTiles.contains (it->first.first, it->first.second))
+                    it = tiles.erase (it);
+                else
+                    ++it;
+            }
+        }
+
+        // Visible tiles get scheduled first
+        requestTiles (list, visibleTiles);
+        requestTiles (list, prefetchTiles);
+
+        RectangleList<int> pendingArea;
+
+        const ScopedLock sl (lock);
+
+        for (int row { visibleTiles.getY() }; row < visibleTiles.getBottom(); ++row)
+        {
+            for (int col { visibleTiles.getX() }; col < visibleTiles.getRight(); ++col)
+            {
+                const Rectangle<int> tileArea (col * tileSize, row * tileSize, tileSize, tileSize);
+                const auto area { tileArea.translated (-viewport.getX(), -viewport.getY()).toFloat() };
+
+                if (const auto it { tiles.find ({ col, row }) }; it != tiles.end() && it->second->ready)
+                {
+                    g.drawImage (it->second->image, area);
+                    continue;
+                }
+
+                pendingArea.add (tileArea.getIntersection (viewport));
+
+                if (const auto it { staleTiles.find ({ col, row }) }; it != staleTiles.end())
+                    g.drawImage (it->second->image, area);
+            }
+        }
+
+        if (pendingArea.isEmpty())
+            staleTiles.clear();
+
+        return pendingArea;
+    }
+
+    /** Called on the message thread when a visible tile has been painted. */
+    std::function<void()> onTilePainted{};
+
+private:
+
+    struct Tile
+    {
+        Image image;
+        std::atomic<bool> ready { false };
+    };
+
+    using TileKey = std::pair<int, int>;
+
+    Rectangle<int> getTileRange (const Rectangle<int>& area) const
+    {
+        if (area.isEmpty())
+            return {};
+
+        const int left { area.getX() / tileSize };
+        const int top { area.getY() / tileSize };
+        const int right { (area.getRight() + tileSize - 1) / tileSize };
+        const int bottom { (area.getBottom() + tileSize - 1) / tileSize };
+
+        return { left, top, right - left, bottom - top };
+    }
+
+    void stopWorkers()
+    {
+        if (pool != nullptr)
+            pool->removeAllJobs (false, -1);
+    }
+
+    /** Drop all the tiles, including the ones kept for an invalidation. */
+    void clear()
+    {
+        stopWorkers();
+
+        const ScopedLock sl (lock);
+        tiles.clear();
+        staleTiles.clear();
+    }
+
+    void requestTiles (const std::shared_ptr<const DisplayList>& list, const Rectangle<int>& range)
+    {
+        const ScopedLock sl (lock);
+
+        for (int row { range.getY() }; row < range.getBottom(); ++row)
+        {
+            for (int col { range.getX() }; col < range.getRight(); ++col)
+            {
+                auto& tile { tiles[{ col, row }] };
+
+                if (tile != nullptr)
+                    continue;
+
+                tile = std::make_shared<Tile>();
+
+                pool->addJob ([this, list, tile, col, row, size = tileSize, scale = tileScale] {
+                    paintTile (*list, *tile, Rectangle<int> (col * size, row * size, size, size), scale);
+
+                    const ScopedLock jobLock (lock);
+
+                    if (visibleRange.contains (col, row))
+                        triggerAsyncUpdate();
+                });
+            }
+        }
+    }
+
+    static void paintTile (const DisplayList& list, Tile& tile, const Rectangle<int>& area, float scale)
+    {
+        Image image (Image::ARGB,
+                     roundToInt (area.getWidth() * scale),
+                     roundToInt (area.getHeight() * scale),
+                     true,
+                     SoftwareImageType());
+
+        {
+            Graphics g (image);
+            g.addTransform (AffineTransform::scale (scale));
+
+            list.replay (g, area);
+        }
+
+        tile.image = image;
+        tile.ready = true;
+    }
+
+    void handleAsyncUpdate() override
+    {
+        if (onTilePainted != nullptr)
+            onTilePainted();
+    }
+
+    int tileSize { 256 };
+    int prefetchMargin { 256 };
+    float tileScale { 1.0f };
+
+    CriticalSection lock;
+    std::map<TileKey, std::shared_ptr<Tile>> tiles;
+    std::map<TileKey, std::shared_ptr<Tile>> staleTiles;
+    Rectangle<int> visibleRange;
+
+    std::unique_ptr<ThreadPool> pool;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TileRenderer)
+};
+
+} // namespace juce_litehtml
@@ -3,12 +3,22 @@ namespace juce_litehtml {
 WebContext::WebContext()
     : loader()
 {
-    // Load default embedded stylesheet
-    load_master_stylesheet (juce_litehtml_master_css);
+    // Use the default embedded stylesheet
+    set_master_stylesheet (getMasterStylesheet());
+
+    // The document nodes are all released together with the document
+    set_use_arena (true);
 }
 
 WebContext::~WebContext() = default;
 
+std::shared_ptr<const litehtml::css> WebContext::getMasterStylesheet()
+{
+    // The initialization of a local static is thread-safe
+    static const std::shared_ptr<const litehtml::css> css { litehtml::context::parse_master_stylesheet (juce_litehtml_master_css) };
+    return css;
+}
+
 litehtml::element::ptr WebContext::create_element (const litehtml::tchar_t* tag_name,
                                                    const litehtml::string_map& attributes,
                                                    const litehtml::document::ptr& doc)
@@ -18,9 +28,9 @@ litehtml::element::ptr WebContext::create_element (const litehtml::tchar_t* tag_
     litehtml::element::ptr element{};
 
     if (tag == "script")
-        element = std::make_shared<el_script>(doc);
+        element = doc->make_element<el_script> (doc);
     else if (tag == "input")
-        element = std::make_shared<el_input>(doc);
+        element = doc->make_element<el_input> (doc);
 
     return element;
 }
@@ -17,6 +17,13 @@ public:
     WebContext();
     ~WebContext();
 
+    /** Returns the embedded default stylesheet.
+
+        The stylesheet is parsed on the first call and then
+        shared by all the contexts of the process.
+     */
+    static std::shared_ptr<const litehtml::css> getMasterStylesheet();
+
     /** Returns the loader. */
     WebLoader& getLoader() { return loader; }
 
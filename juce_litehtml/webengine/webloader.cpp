@@ -116,6 +116,55 @@ String WebLoader::loadTextSync (const juce::URL& url)
     return content;
 }
 
+Image WebLoader::loadImageSync (const juce::URL& url)
+{
+    Image image;
+
+    if (loadLocalOrCached (url, image))
+        return image;
+
+    const auto fixedUrl { fixUpURL (url) };
+
+    MemoryBlock data;
+
+    if (! fixedUrl.readEntireBinaryStream (data))
+        return {};
+
+    // Save to cache
+    const auto file { getCachedResource (fixedUrl) };
+    file.replaceWithData (data.getData(), data.getSize());
+
+    return ImageFileFormat::loadFrom (data.getData(), data.getSize());
+}
+
+bool WebLoader::probeImageSize (const URL& url, int& width, int& height)
+{
+    const auto fixedUrl { fixUpURL (url) };
+    std::unique_ptr<InputStream> stream;
+
+    if (fixedUrl.getScheme() == "res")
+    {
+#if JUCE_TARGET_HAS_BINARY_DATA
+        if (auto* resourceName { getBinaryDataResourceNameForFile (fixedUrl.getFileName()) })
+        {
+            int size{};
+
+            if (const auto* data { BinaryData::getNamedResource (resourceName, size) })
+                stream = std::make_unique<MemoryInputStream> (data, (size_t) size, false);
+        }
+#endif
+    }
+    else
+    {
+        const auto file { fixedUrl.isLocalFile() ? fixedUrl.getLocalFile() : getCachedResource (fixedUrl) };
+
+        if (fixedUrl.isLocalFile() || isCachedResourceValid (file))
+            stream = file.createInputStream();
+    }
+
+    return stream != nullptr && readImageSize (*stream, width, height);
+}
+
 URL WebLoader::fixUpURL (const URL& url) const
 {
     if (url.getScheme().isEmpty())
@@ -233,6 +282,109 @@ Image WebLoader::loadImageFromFile (const File& file)
     return ImageCache::getFromFile (file);
 }
 
+bool WebLoader::readImageSize (InputStream& stream, int& width, int& height)
+{
+    uint8 header[24] {};
+
+    if (stream.read (header, 4) != 4)
+        return false;
+
+    const auto readBytes = [&stream] (uint8* data, int size) -> bool {
+        return stream.read (data, size) == size;
+    };
+
+    const auto bigEndian16 = [] (const uint8* data) -> int {
+        return (data[0] << 8) | data[1];
+    };
+
+    // PNG: the signature followed by the IHDR chunk
+    if (header[0] == 0x89 && header[1] == 'P' && header[2] == 'N' && header[3] == 'G')
+    {
+        if (! readBytes (header + 4, 20) || memcmp (header + 12, "IHDR", 4) != 0)
+            return false;
+
+        width = (int) ByteOrder::bigEndianInt (header + 16);
+        height = (int) ByteOrder::bigEndianInt (header + 20);
+        return true;
+    }
+
+    // GIF: the logical screen size follows the signature
+    if (header[0] == 'G' && header[1] == 'I' && header[2] == 'F')
+    {
+        if (! readBytes (header + 4, 6))
+            return false;
+
+        width = header[6] | (header[7] << 8);
+        height = header[8] | (header[9] << 8);
+        return true;
+    }
+
+    // JPEG: walk the segments up to the start of frame
+    if (header[0] == 0xff && header[1] == 0xd8)
+    {
+        uint8 marker { header[3] };
+
+        if (header[2] != 0xff)
+            return false;
+
+        for (;;)
+        {
+            // Skip the fill bytes
+            while (marker == 0xff)
+            {
+                if (! readBytes (&marker, 1))
+                    return false;
+            }
+
+            // Standalone markers have no length
+            if (marker == 0x01 || (marker >= 0xd0 && marker <= 0xd8))
+            {
+                uint8 prefix[2] {};
+
+                if (! readBytes (prefix, 2) || prefix[0] != 0xff)
+                    return false;
+
+                marker = prefix[1];
+                continue;
+            }
+
+            uint8 length[2] {};
+
+            if (! readBytes (length, 2))
+                return false;
+
+            const int segmentSize { bigEndian16 (length) - 2 };
+
+            const bool isStartOfFrame { marker >= 0xc0 && marker <= 0xcf
+                                        && marker != 0xc4 && marker != 0xc8 && marker != 0xcc };
+
+            if (isStartOfFrame)
+            {
+                uint8 frame[5] {};
+
+                if (segmentSize < 5 || ! readBytes (frame, 5))
+                    return false;
+
+                height = bigEndian16 (frame + 1);
+                width = bigEndian16 (frame + 3);
+                return width > 0 && height > 0;
+            }
+
+            if (segmentSize < 0 || stream.skipNextBytes (segmentSize) != segmentSize)
+                return false;
+
+            uint8 prefix[2] {};
+
+            if (! readBytes (prefix, 2) || prefix[0] != 0xff)
+                return false;
+
+            marker = prefix[1];
+        }
+    }
+
+    return false;
+}
+
 void WebLoader::finished (URL::DownloadTask* task, bool success)
 {
     jassert (task != nullptr);
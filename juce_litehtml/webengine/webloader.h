@@ -91,6 +91,12 @@ public:
      */
     juce::String loadTextSync (const juce::URL& url);
 
+    /** Load image resource synchronously.
+
+        Same as loadTextSync() but for images.
+     */
+    juce::Image loadImageSync (const juce::URL& url);
+
     /** Load local or cached resource synchronously.
 
         This method delivers local reources (local files or embedded binary),
@@ -113,6 +119,15 @@ public:
         return false;
     }
 
+    /** Read the image dimensions without decoding the image.
+
+        Only the PNG, JPEG and GIF headers get parsed. This works
+        for the local, embedded and already cached images.
+
+        @returns false if the size could not be read.
+     */
+    bool probeImageSize (const juce::URL& url, int& width, int& height);
+
     juce::URL fixUpURL (const juce::URL& url) const;
 
 private:
@@ -127,6 +142,7 @@ private:
     static juce::String loadTextFromResource (const juce::String& resName);
     static juce::Image loadImageFromResource (const juce::String& resName);
     static juce::Image loadImageFromFile (const juce::File& file);
+    static bool readImageSize (juce::InputStream& stream, int& width, int& height);
 
     // juce::URL::DownloadTask::Listener
     void finished (juce::URL::DownloadTask* task, bool success) override;
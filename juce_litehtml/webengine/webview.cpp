@@ -2,579 +2,462 @@ namespace juce_litehtml {
 
 using namespace litehtml;
 
-class Renderer final : public litehtml::document_container
+constexpr static int scrollBarSize { 10 };
+
+struct WebView::Impl : public WebPage::ViewClient,
+                       public ScrollBar::Listener,
+                       public ComponentListener,
+                       public ComponentPeer::ScaleFactorListener
 {
-public:
-    Renderer (WebView& view)
-        : webView (view)
-    {}
-
-    uint_ptr create_font (const tchar_t* faceName,
-                          int size,
-                          int weight,
-                          font_style style,
-                          unsigned int decoration,
-                          font_metrics* fm) override
-    {
-        String fontName { juceString (faceName) };
-        int styleFlags { Font::plain };
-
-        if (decoration & font_decoration_underline)
-            styleFlags |= Font::underlined;
-        if (style == litehtml::fontStyleItalic)
-            styleFlags |= Font::italic;
-        if (weight >= 500)
-            styleFlags |= Font::bold;
-
-        auto font { std::make_unique<Font> (fontName, (float) size, styleFlags) };
-
-        if (fm != nullptr)
-        {
-            fm->ascent = (int)font->getAscent();
-            fm->descent = (int)font->getDescent();
-            fm->height = (int)font->getHeight();
-            fm->x_height = fm->height;  // 'x' character height
-            fm->draw_spaces = (style == litehtml::fontStyleItalic || decoration != 0);
-        }
+    WebView& self;
+    Renderer renderer;
+    WebPage* page { nullptr };
 
-        return (uint_ptr) font.release();
-    }
+    std::shared_ptr<const DisplayList> displayList;
+    TileRenderer tileRenderer;
+    bool tiledRendering { false };
 
-    void delete_font (uint_ptr hFont) override
-    {
-        auto* font { static_cast<Font*>((void*) hFont) };
-        delete font;
-    }
+    /// Elements hosting child components that are positioned when painted.
+    litehtml::elements_vector embeddedElements;
 
-    int text_width (const tchar_t* text, uint_ptr hFont) override
-    {
-        if (auto* font { static_cast<Font*>((void*) hFont) })
-            return font->getStringWidth (juceString (text));
+    /// Painted viewport, its pixels get moved when scrolling.
+    Image backBuffer;
+    Point<int> backBufferScroll;
+    float backBufferScale { 1.0f };
+    bool backBufferValid { false };
 
-        return 0;
-    }
+    /// Back buffer area in the document coordinates waiting for its tiles.
+    RectangleList<int> pendingTiles;
+    bool tilesPainted { false };
 
-    void draw_text (uint_ptr hdc, const tchar_t* text, uint_ptr hFont, web_color color, const position& pos) override
+    struct FixedLayer
     {
-        if (auto* g { static_cast<Graphics*>((void*) hdc) })
-        {
-            if (auto* font { static_cast<Font*> ((void*) hFont) })
-                g->setFont(*font);
+        litehtml::element::ptr element;
+        Rectangle<int> placement;
+        Rectangle<int> area;
+        Image image;
+    };
 
-            g->setColour (webColour (color));
+    /// Fixed boxes painted separately from the scrolled content.
+    std::vector<FixedLayer> fixedLayers;
+    float fixedLayersScale { 1.0f };
+    bool fixedLayersValid { false };
 
-            Rectangle<int> rect (pos.x, pos.y, pos.width, pos.height);
-            g->drawText (juceString (text), rect, Justification::left);
-        }
-    }
+    /// View areas restyled since the fixed layers were painted.
+    RectangleList<int> fixedRedrawArea;
 
-    int pt_to_px (int pt) const override
-    {
-        const auto& displays { Desktop::getInstance().getDisplays() };
+    ScrollBar vScrollBar;
+    ScrollBar hScrollBar;
+    int scrollX { 0 };
+    int scrollY { 0 };
 
-        if (auto* display { displays.getPrimaryDisplay() })
-            return (int) (display->dpi * pt / 72.0 / display->scale);
+    /// Distance from the viewport the lazy images get loaded at.
+    int lazyImagesDistance { 1024 };
 
-        return pt * 8 / 6;
-    }
+    /// Coalesces the relayout requests into one per frame.
+    FrameScheduler frameScheduler;
 
-    int get_default_font_size() const override
+    /// Window and peer watched for a move to another display or a scale change.
+    Component::SafePointer<Component> watchedWindow;
+    ComponentPeer* watchedPeer { nullptr };
+
+    Impl (WebView& wv)
+        : self { wv },
+          vScrollBar (true),
+          hScrollBar (false),
+          frameScheduler (wv, [this](int reasons, int numRequests) { performFrame (reasons, numRequests); })
     {
-        return 16;
+        renderer.followLink = [this](const URL& url) -> void { followLink (url); };
+        renderer.imageLoaded = [this]() -> void { frameScheduler.schedule (WebView::updateImageLoaded); };
+        tileRenderer.onTilePainted = [this]() -> void { tilesPainted = true; self.repaint(); };
+        updateDisplayMetrics();
+
+        vScrollBar.setAutoHide (false);
+        hScrollBar.setAutoHide (false);
+
+        vScrollBar.setSingleStepSize (16);
+        hScrollBar.setSingleStepSize (16);
+
+        self.addAndMakeVisible (vScrollBar);
+        self.addAndMakeVisible (hScrollBar);
+
+        vScrollBar.addListener (this);
+        hScrollBar.addListener (this);
     }
 
-    const tchar_t* get_default_font_name() const override
+    ~Impl() override
     {
-        return _t("Tahoma");
+        watchDisplay (nullptr, nullptr);
     }
 
-    void draw_list_marker (uint_ptr hdc, const list_marker& marker) override
+    void setPage (WebPage* newPage)
     {
-        if (auto* g { static_cast<Graphics*> ((void*) hdc) })
+        if (page != nullptr)
         {
-            const auto& pos { marker.pos };
-            g->setColour (webColour (marker.color));
-
-            switch (marker.marker_type)
-            {
-                case list_style_type_none:
-                    break;
-                case list_style_type_circle:
-                    g->drawEllipse (pos.x, pos.y, pos.width, pos.height, 1.0f);
-                    break;
-                case list_style_type_disc:
-                    g->fillEllipse (pos.x, pos.y, pos.width, pos.height);
-                    break;
-                case list_style_type_square:
-                    g->fillRect (pos.x, pos.y, pos.width, pos.height);
-                    break;
-                default:
-                    g->drawRect (pos.x, pos.y, pos.width, pos.height);
-                    break;
-            }
+            page->setViewClient (nullptr);
+            page->setRenderer (nullptr);
         }
-    }
 
-    void load_image (const tchar_t* src, const tchar_t* baseurl, bool redraw_on_ready) override
-    {
-        if (auto* loader { getLoader() })
+        page = newPage;
+
+        renderer.setLoader (page != nullptr ? &page->getLoader() : nullptr);
+        renderer.setContext (page != nullptr ? &page->getContext() : nullptr);
+
+        if (page != nullptr)
         {
-            const URL url (juceString (src));
-
-            loader->loadAsync<Image> (url, [this, url, redraw_on_ready](bool ok, const Image& image) {
-                if (ok && ! image.isNull())
-                {
-                    // Cache image size
-                    imageSizeCache[url.toString (true).hash()] = { image.getWidth(), image.getHeight() };
-
-                    if (redraw_on_ready)
-                    {
-                        webView.resized();
-                        webView.repaint();
-                    }
-                }
-            });
+            page->setViewClient (this);
+            page->setRenderer (&renderer);
         }
     }
 
-    void get_image_size (const tchar_t* src, const tchar_t* baseurl, litehtml::size& sz) override
+    void render()
     {
-        if (auto* loader { getLoader() })
-        {
-            URL url (juceString (src));
-
-            if (auto it { imageSizeCache.find (url.toString (true).hash()) }; it != imageSizeCache.end())
-            {
-                sz.width = it->second.width;
-                sz.height = it->second.height;
-                return;
-            }
+        if (page == nullptr)
+            return;
 
-            // Image has not been cached, force local load
-            Image image{};
-            const bool ok { loader->loadLocal (url, image) };
+        auto document { page->getDocument() };
 
-            if (ok && ! image.isNull())
-            {
-                sz.width = image.getWidth();
-                sz.height = image.getHeight();
-                return;
-            }
-        }
+        if (document == nullptr)
+            return;
 
-        sz.width = 0;
-        sz.height = 0;
-    }
+        const auto width { self.getWidth() };
+        const auto height { self.getHeight() };
 
-    void draw_background (uint_ptr hdc, const background_paint &bg) override
-    {
-        if (auto* g { static_cast<Graphics*> ((void*) hdc) })
-        {
-            if (bg.image.empty())
-            {
-                Rectangle<int> rect;
-                rect.setX (bg.position_x + bg.clip_box.left());
-                rect.setY (bg.position_y + bg.clip_box.top());
-                rect.setWidth (bg.clip_box.width);
-                rect.setHeight (bg.clip_box.height);
-
-                g->setColour (webColour (bg.color));
-                g->fillRect (rect);
-            }
-            else if (auto* loader { getLoader() })
-            {
-                const URL url (juceString (bg.image));
-                Image image;
-                const bool ok { loader->loadLocalOrCached<Image> (url, image) };
-
-                if (ok && !image.isNull())
-                {
-                    // @todo handle background paint correctly
-                    Rectangle<float> frect;
-                    frect.setLeft (bg.position_x);
-                    frect.setTop (bg.position_y);
-                    frect.setWidth (bg.clip_box.width);
-                    frect.setHeight (bg.clip_box.height);
-
-                    if (bg.repeat == background_repeat_repeat)
-                        g->drawImage (image, frect, RectanglePlacement::fillDestination);
-                    else
-                        g->drawImage (image, frect, RectanglePlacement::stretchToFit);
-                }
-            }
-        }
-    }
+        // Painted tiles must be released before the layout gets changed
+        tileRenderer.invalidate();
+        renderer.clearTextRuns();
+        displayList.reset();
+        backBufferValid = false;
 
-    void draw_borders (uint_ptr hdc, const borders& borders, const position& draw_pos, [[maybe_unused]] bool root) override
-    {
-        if (auto* g { static_cast<Graphics*> ((void*) hdc) })
-        {
-            int bdr_top { 0 };
-            int bdr_bottom { 0 };
-            int bdr_left { 0 };
-            int bdr_right { 0 };
+        document->render (width, litehtml::render_all);
 
-            if (borders.top.width > 0 && borders.top.style > border_style_hidden)
-                bdr_top = borders.top.width;
+        embeddedElements = document->root()->select_all (_t("input"));
 
-            if (borders.bottom.width > 0 && borders.bottom.style > border_style_hidden)
-                bdr_bottom = borders.bottom.width;
+        const auto documentWidth { document->width() };
+        const auto documentHeight { document->height() };
 
-            if (borders.left.width > 0 && borders.left.style > border_style_hidden)
-                bdr_left = borders.left.width;
+        const auto hRange { jmax (0, documentWidth - width) };
+        const auto vRange { jmax (0, documentHeight - height) };
 
-            if (borders.right.width > 0 && borders.right.style > border_style_hidden)
-                bdr_right = borders.right.width;
+        hScrollBar.setVisible (hRange > 0);
+        vScrollBar.setVisible (vRange > 0);
 
-            // @todo Draw rounded boxes
 
-            if (bdr_top)
-            {
-                g->setColour (webColour (borders.top.color));
-                g->drawLine (draw_pos.left(), draw_pos.top(), draw_pos.right(), draw_pos.top());
-            }
+        hScrollBar.setRangeLimits (0, documentWidth, dontSendNotification);
+        vScrollBar.setRangeLimits (0, documentHeight, dontSendNotification);
 
-            if (bdr_bottom)
-            {
-                g->setColour (webColour (borders.bottom.color));
-                g->drawLine (draw_pos.left(), draw_pos.bottom(), draw_pos.right(), draw_pos.bottom());
-            }
+        hScrollBar.setCurrentRange (scrollX, width - (vRange > 0 ? scrollBarSize : 0));
+        vScrollBar.setCurrentRange (scrollY, height - (hRange > 0 ? scrollBarSize : 0));
 
-            if (bdr_left)
-            {
-                g->setColour (webColour (borders.left.color));
-                g->drawLine (draw_pos.left(), draw_pos.top(), draw_pos.left(), draw_pos.bottom());
-            }
+        hScrollBar.setBounds(0, height - scrollBarSize, vRange > 0 ? width - scrollBarSize : width, scrollBarSize);
+        vScrollBar.setBounds(width - scrollBarSize, 0, scrollBarSize, hRange > 0 ? height - scrollBarSize : height);
 
-            if (bdr_right)
-            {
-                g->setColour (webColour (borders.right.color));
-                g->drawLine (draw_pos.right(), draw_pos.top(), draw_pos.right(), draw_pos.bottom());
-            }
-        }
+        loadNearbyImages (*document);
     }
 
-    void set_caption (const tchar_t* caption) override
-    {
-       // @todo Notify caption changed
-    }
+    /** Request the lazy images that got near the viewport.
 
-    void set_base_url (const tchar_t* base_url) override
+        This must be called after the document layout, as the images
+        are found by their laid out position.
+     */
+    void loadNearbyImages (litehtml::document& document)
     {
-        if (auto* loader { getLoader() })
-        {
-            const String sUrl (juceString (base_url));
-            loader->setBaseURL (sUrl);
-        }
-    }
+        if (! document.has_lazy_images())
+            return;
 
-    void link (const std::shared_ptr<litehtml::document>& doc, const litehtml::element::ptr& el) override
-    {
-        // @todo
-        // Called when el_link element gets parsed
-    }
+        const litehtml::position area (scrollX - lazyImagesDistance,
+                                       scrollY - lazyImagesDistance,
+                                       self.getWidth() + 2 * lazyImagesDistance,
+                                       self.getHeight() + 2 * lazyImagesDistance);
 
-    void on_anchor_click (const tchar_t* turl, const litehtml::element::ptr& el) override
-    {
-        if (followLink)
-        {
-            const URL url (juceString (turl));
-            followLink (url);
-        }
+        document.load_lazy_images (area);
     }
 
-    void set_cursor (const tchar_t* cursor) override
+    void paint (Graphics& g)
     {
-        static std::map<String, MouseCursor::StandardCursorType> cursorTypes
-        {
-            { "none",       MouseCursor::NoCursor           },
-            { "auto",       MouseCursor::ParentCursor       },
-            { "pointer",    MouseCursor::PointingHandCursor },
-            { "crosshair",  MouseCursor::CrosshairCursor    }
-        };
+        // @todo Get the colour from <body> style
+        g.fillAll (Colours::white);
 
-        auto cur { MouseCursor::NormalCursor };
-        const String cursorName { juceString (cursor).toLowerCase().trim() };
+        if (page == nullptr)
+            return;
 
-        if (const auto it { cursorTypes.find (cursorName) }; it != cursorTypes.end())
-            cur = it->second;
+        auto document { page->getDocument() };
 
-        // @todo Updaye mouse cursor
-        // webView.setMouseCursor (cur);
-    }
+        if (document == nullptr)
+            return;
 
-    void transform_text (litehtml::tstring& text, litehtml::text_transform tt) override
-    {
-        String str { juceString (text.c_str()) };
+        const auto width { vScrollBar.isVisible() ? self.getWidth() - vScrollBar.getWidth() : self.getWidth() };
+        const auto height { hScrollBar.isVisible() ? self.getHeight() - hScrollBar.getHeight() : self.getHeight() };
 
-        switch (tt)
-        {
-            case text_transform::text_transform_uppercase:
-                str = str.toUpperCase();
-                break;
-            case text_transform::text_transform_lowercase:
-                str = str.toLowerCase();
-                break;
-            case text_transform::text_transform_capitalize:
-                if (str.isNotEmpty())
-                {
-                    str = str.substring (0,1).toUpperCase() + str.substring (1, str.length() - 1);
-                }
-            case text_transform::text_transform_none:
-            default:
-                break;
-        }
+        if (width <= 0 || height <= 0)
+            return;
 
-    #ifdef LITEHTML_UTF8
-        text = litehtml::tstring (str.toStdString());
-    #else
-        text = litehtml::tstring (str.toWideCharPointer());
-    #endif
-    }
+        updateBackBuffer (document, width, height, g.getInternalContext().getPhysicalPixelScaleFactor());
+        updatePendingTiles (document, width, height);
 
-    void import_css (tstring& text, const tstring& tsurl, tstring& baseurl) override
-    {
-        if (auto* loader { getLoader() })
-        {
-            const URL url (juceString (tsurl));
-            const String content { loader->loadTextSync (url) };
+        g.drawImage (backBuffer, { 0.0f, 0.0f, (float) width, (float) height });
 
-            text = to_tstring (content);
-        }
-    }
+        // Fixed boxes stacked above everything are composited over the scrolled content
+        updateFixedLayers (document, width, height, backBufferScale);
 
-    void import_script (tstring& text, const tstring& tsurl) override
-    {
-        if (auto* loader { getLoader() })
+        for (const auto& layer : fixedLayers)
         {
-            const URL url (juceString (tsurl));
-            const String content { loader->loadTextSync (url) };
-
-            text = to_tstring (content);
+            if (layer.image.isValid())
+                g.drawImage (layer.image, layer.area.toFloat());
         }
-    }
 
-    void set_clip (litehtml::uint_ptr hdc, const position &pos, const border_radiuses &bdr_radius, bool valid_x, bool valid_y) override
-    {
-        if (auto* g { static_cast<Graphics*> ((void*) hdc) })
-        {
-            g->saveState();
-            const auto clip { g->getClipBounds() };
-            g->reduceClipRegion(valid_x ? pos.x : clip.getX(),
-                                valid_y ? pos.y : clip.getY(),
-                                valid_x ? pos.width : clip.getWidth(),
-                                valid_y ? pos.height : clip.getHeight());
-        }
+        placeEmbeddedComponents();
     }
 
-    void del_clip(litehtml::uint_ptr hdc) override
+    /** Bring the back buffer up to date with the scroll position.
+
+        The back buffer holds the document content with no fixed layers.
+        When scrolled, the painted pixels are moved and only the area
+        uncovered gets painted.
+     */
+    void updateBackBuffer (const litehtml::document::ptr& document, int width, int height, float scale)
     {
-        if (auto* g { static_cast<Graphics*> ((void*) hdc) })
+        const Rectangle<int> viewArea (0, 0, width, height);
+        const Point<int> scroll (scrollX, scrollY);
+
+        const int pixelWidth { roundToInt (width * scale) };
+        const int pixelHeight { roundToInt (height * scale) };
+
+        if (! backBufferValid
+            || backBuffer.getWidth() != pixelWidth
+            || backBuffer.getHeight() != pixelHeight
+            || backBufferScale != scale)
         {
-            g->restoreState();
+            backBuffer = Image (Image::RGB, pixelWidth, pixelHeight, false);
+            backBufferScale = scale;
+            backBufferScroll = scroll;
+            backBufferValid = true;
+
+            paintBackBuffer (document, viewArea, viewArea);
+            return;
         }
-    }
 
-    void get_client_rect (position& client) const override
-    {
-        client.x = 0;
-        client.y = 0;
-        client.width = webView.getWidth();
-        client.height = webView.getHeight();
-    }
+        const auto delta { scroll - backBufferScroll };
 
-    litehtml::element::ptr create_element (const litehtml::tchar_t *tag_name,
-                                           const litehtml::string_map &attributes,
-                                           const litehtml::document::ptr& doc) override
-    {
-        if (auto* page { webView.getPage() })
-            return page->getContext().create_element (tag_name, attributes, doc);
+        if (delta == Point<int>())
+            return;
 
-        return nullptr;
-    }
+        backBufferScroll = scroll;
 
-    void get_media_features(litehtml::media_features &media) const override
-    {
-        const auto& displays { Desktop::getInstance().getDisplays() };
+        // Pixels can only be moved by a whole number of device pixels
+        const auto pixelDelta { delta.toFloat() * scale };
+        const int dx { roundToInt (pixelDelta.x) };
+        const int dy { roundToInt (pixelDelta.y) };
 
-        if (auto* display { displays.getPrimaryDisplay() })
+        if (std::abs (delta.x) >= width || std::abs (delta.y) >= height
+            || (float) dx != pixelDelta.x || (float) dy != pixelDelta.y)
         {
-            media.width = display->userArea.getWidth();
-            media.height = display->userArea.getHeight();
-            media.resolution = (int) display->dpi;
-            media.device_width = display->totalArea.getWidth();
-            media.device_height = display->totalArea.getHeight();
+            paintBackBuffer (document, viewArea, viewArea);
+            return;
         }
-        else
+
+        backBuffer.moveImageSection (jmax (0, -dx), jmax (0, -dy),
+                                     jmax (0, dx), jmax (0, dy),
+                                     pixelWidth - std::abs (dx), pixelHeight - std::abs (dy));
+
+        RectangleList<int> dirtyArea (viewArea);
+        dirtyArea.subtract (viewArea.translated (-delta.x, -delta.y));
+
+        if (document->has_scrolled_fixed())
         {
-            // Dummy values
-            media.width = 1024;
-            media.height = 768;
-            media.resolution = 72;
-            media.device_width = 1024;
-            media.device_height = 768;
+            // Fixed boxes drawn with the content have been moved along with it,
+            // so both their old and new places must be painted.
+            litehtml::position::vector fixedBoxes;
+            document->get_fixed_boxes (fixedBoxes);
+
+            for (const auto& box : fixedBoxes)
+            {
+                const Rectangle<int> area (box.x, box.y, box.width, box.height);
+                dirtyArea.add (area);
+                dirtyArea.add (area.translated (-delta.x, -delta.y));
+            }
+
+            dirtyArea.clipTo (viewArea);
         }
 
-        media.type = litehtml::media_type_screen;
-        media.color = 8;
-        media.monochrome = 0;
-        media.color_index = 256;
+        if (! dirtyArea.isEmpty())
+            paintBackBuffer (document, dirtyArea, viewArea);
     }
 
-    void get_language (tstring &language, tstring &culture) const override
+    /** Paint the back buffer areas whose tiles have been painted since. */
+    void updatePendingTiles (const litehtml::document::ptr& document, int width, int height)
     {
-        language = _t("en");
-        culture = _t("en-GB");
-    }
+        if (! tilesPainted)
+            return;
 
-    tstring resolve_color (const tstring &color) const override
-    {
-        String colorName { juceString (color.c_str()) };
+        tilesPainted = false;
 
-        Colour c { Colours::findColourForName (colorName, Colour::fromString (colorName)) };
-        String strColour = String ("#") + c.toDisplayString (true);
+        const Rectangle<int> viewArea (0, 0, width, height);
 
-    #ifdef LITEHTML_UTF8
-        return litehtml::tstring (strColour.toStdString());
-    #else
-        return litehtml::tstring (strColour.toWideCharPointer());
-    #endif
+        auto area { pendingTiles };
+        area.offsetAll (-scrollX, -scrollY);
+        area.clipTo (viewArea);
+
+        if (! area.isEmpty())
+            paintBackBuffer (document, area, viewArea);
     }
 
-    // Callbacks
+    void paintBackBuffer (const litehtml::document::ptr& document, const RectangleList<int>& area, const Rectangle<int>& viewArea)
+    {
+        pendingTiles.clear();
+
+        Graphics g (backBuffer);
+        g.addTransform (AffineTransform::scale (backBufferScale));
+        g.reduceClipRegion (area);
 
-    std::function<void (const URL&)> followLink{};
+        // @todo Get the colour from <body> style
+        g.fillAll (Colours::white);
 
-private:
+        if (displayList == nullptr)
+            displayList = recordDisplayList (*document);
 
-    WebLoader* getLoader()
-    {
-        if (auto* page { webView.getPage() })
-            return &page->getLoader();
+        const Rectangle<int> viewport (scrollX, scrollY, viewArea.getWidth(), viewArea.getHeight());
 
-        return nullptr;
+        if (document->has_scrolled_fixed())
+        {
+            // Fixed boxes stacked under other content are replayed at the
+            // scroll position, which the tiles cannot be painted for.
+            displayList->replay (g, viewport, viewport.getPosition());
+        }
+        else if (tiledRendering)
+            pendingTiles = tileRenderer.paint (g, displayList, { 0, 0, document->width(), document->height() }, viewport);
+        else
+            displayList->replay (g, viewport);
     }
 
-    WebView& webView;
+    /** Rasterise each fixed box subtree into its own layer.
 
-    struct ImageSize
+        Only the fixed boxes drawn after all the scrolled content get a
+        layer, the others are recorded with the content to keep their
+        stacking order. The layers do not depend on the scroll position.
+        After a restyle, a layer is only painted again if a restyled area
+        touches it or its element has moved.
+     */
+    void updateFixedLayers (const litehtml::document::ptr& document, int width, int height, float scale)
     {
-        int width;
-        int height;
-    };
+        const bool repaintAll { ! fixedLayersValid || fixedLayersScale != scale };
+        const auto& elements { document->get_fixed_elements() };
 
-    std::map<size_t, ImageSize> imageSizeCache;
-};
+        fixedLayers.resize (elements.size());
+        fixedLayersScale = scale;
+        fixedLayersValid = true;
 
-//==============================================================================
-
-constexpr static int scrollBarSize { 10 };
+        const Rectangle<int> viewArea (0, 0, width, height);
 
-struct WebView::Impl : public WebPage::ViewClient,
-                       public ScrollBar::Listener
-{
-    WebView& self;
-    Renderer renderer;
-    WebPage* page { nullptr };
+        for (size_t i = 0; i < elements.size(); ++i)
+        {
+            auto& layer { fixedLayers[i] };
+            const auto& el { elements[i] };
+
+            if (repaintAll
+                || layer.element != el
+                || layer.placement != getPlacement (*el)
+                || ! layer.image.isValid()
+                || fixedRedrawArea.intersectsRectangle (layer.area))
+            {
+                paintFixedLayer (*document, layer, el, viewArea, scale);
+            }
+        }
 
-    ScrollBar vScrollBar;
-    ScrollBar hScrollBar;
-    int scrollX { 0 };
-    int scrollY { 0 };
+        fixedRedrawArea.clear();
+    }
 
-    Impl (WebView& wv)
-        : self { wv },
-          renderer (wv),
-          vScrollBar (true),
-          hScrollBar (false)
+    void paintFixedLayer (litehtml::document& document, FixedLayer& layer, const litehtml::element::ptr& el,
+                          const Rectangle<int>& viewArea, float scale)
     {
-        renderer.followLink = [this](const URL& url) -> void { followLink (url); };
+        litehtml::position client;
+        renderer.get_client_rect (client);
 
-        vScrollBar.setAutoHide (false);
-        hScrollBar.setAutoHide (false);
+        DisplayList list;
+        document.draw_fixed_element ((litehtml::uint_ptr) &list, el, client.x, client.y, nullptr);
+        list.optimise();
 
-        vScrollBar.setSingleStepSize (16);
-        hScrollBar.setSingleStepSize (16);
+        layer.element = el;
+        layer.placement = getPlacement (*el);
+        layer.area = list.getBounds().getSmallestIntegerContainer().getIntersection (viewArea);
+        layer.image = {};
 
-        self.addAndMakeVisible (vScrollBar);
-        self.addAndMakeVisible (hScrollBar);
+        if (layer.area.isEmpty())
+            return;
 
-        vScrollBar.addListener (this);
-        hScrollBar.addListener (this);
+        layer.image = Image (Image::ARGB, roundToInt (layer.area.getWidth() * scale), roundToInt (layer.area.getHeight() * scale), true);
+
+        Graphics g (layer.image);
+        g.addTransform (AffineTransform::scale (scale));
+        list.replay (g, layer.area);
     }
 
-    void setPage (WebPage* newPage)
+    static Rectangle<int> getPlacement (const litehtml::element& el)
     {
-        if (page != nullptr)
-        {
-            page->setViewClient (nullptr);
-            page->setRenderer (nullptr);
-        }
+        const auto pos { el.get_placement() };
+        return { pos.x, pos.y, pos.width, pos.height };
+    }
 
-        page = newPage;
+    /** Record the areas restyled by a mouse event for the fixed layers.
 
-        if (page != nullptr)
+        The boxes within fixed elements are relative to the viewport and
+        the others to the document, so each box is taken either way.
+     */
+    void addRedrawBoxes (const std::vector<litehtml::position>& boxes)
+    {
+        for (const auto& box : boxes)
         {
-            page->setViewClient (this);
-            page->setRenderer (&renderer);
+            const Rectangle<int> area (box.x, box.y, box.width, box.height);
+            fixedRedrawArea.add (area);
+            fixedRedrawArea.add (area.translated (-scrollX, -scrollY));
         }
     }
 
-    void render()
+    void setTiledRendering (bool shouldUseTiles, int tileSize, int prefetchMargin)
     {
-        if (page == nullptr)
-            return;
-
-        auto document { page->getDocument() };
-
-        if (document == nullptr)
-            return;
-
-        const auto width { self.getWidth() };
-        const auto height { self.getHeight() };
-
-        document->render (width, litehtml::render_all);
+        tileRenderer.setEnabled (shouldUseTiles);
+        tileRenderer.setTileSize (tileSize);
+        tileRenderer.setPrefetchMargin (prefetchMargin);
 
-        const auto documentWidth { document->width() };
-        const auto documentHeight { document->height() };
-
-        const auto hRange { jmax (0, documentWidth - width) };
-        const auto vRange { jmax (0, documentHeight - height) };
+        if (tiledRendering != shouldUseTiles)
+        {
+            tiledRendering = shouldUseTiles;
+            frameScheduler.schedule (WebView::updateSettingsChanged);
+        }
+    }
 
-        hScrollBar.setVisible (hRange > 0);
-        vScrollBar.setVisible (vRange > 0);
+    /** Record the document drawing for the paints and the tile workers.
 
+        Like every document draw this runs on the message thread, the tile
+        workers replay the immutable snapshot so the mouse handlers can
+        restyle the live document while tiles are being painted.
+     */
+    static std::shared_ptr<const DisplayList> recordDisplayList (litehtml::document& document)
+    {
+        JUCE_ASSERT_MESSAGE_THREAD
 
-        hScrollBar.setRangeLimits (0, documentWidth, dontSendNotification);
-        vScrollBar.setRangeLimits (0, documentHeight, dontSendNotification);
+        auto list { std::make_shared<DisplayList>() };
 
-        hScrollBar.setCurrentRange (scrollX, width - (vRange > 0 ? scrollBarSize : 0));
-        vScrollBar.setCurrentRange (scrollY, height - (hRange > 0 ? scrollBarSize : 0));
+        // The whole document gets recorded with no clip,
+        // the fixed boxes on top are painted into their own layers.
+        document.draw ((litehtml::uint_ptr) list.get(), 0, 0, nullptr, litehtml::render_no_fixed);
+        list->optimise();
 
-        hScrollBar.setBounds(0, height - scrollBarSize, vRange > 0 ? width - scrollBarSize : width, scrollBarSize);
-        vScrollBar.setBounds(width - scrollBarSize, 0, scrollBarSize, hRange > 0 ? height - scrollBarSize : height);
+        return list;
     }
 
-    void paint (Graphics& g)
+    void placeEmbeddedComponents()
     {
-        // @todo Get the colour from <body> style
-        g.fillAll (Colours::white);
-
-        if (page == nullptr)
-            return;
-
-        auto document { page->getDocument() };
-
-        if (document == nullptr)
-            return;
-
-        const auto width { vScrollBar.isVisible() ? self.getWidth() - vScrollBar.getWidth() : self.getWidth() };
-        const auto height { hScrollBar.isVisible() ? self.getHeight() - hScrollBar.getHeight() : self.getHeight() };
-
-        litehtml::position clip (0, 0, width, height);
-
-        // Draw document at scroll position
-        document->draw ((litehtml::uint_ptr)&g, -scrollX, -scrollY, &clip);
+        // The document drawing is recorded and replayed later,
+        // so the embedded components are positioned here instead.
+        for (auto& el : embeddedElements)
+        {
+            if (auto* input { dynamic_cast<el_input*> (el.get()) })
+            {
+                const auto placement { input->get_placement() };
+                input->placeComponent (placement.x - scrollX, placement.y - scrollY);
+            }
+        }
     }
 
     void mouseMove(const MouseEvent& event)
@@ -593,7 +476,10 @@ struct WebView::Impl : public WebPage::ViewClient,
         std::vector<litehtml::position> redrawBoxes;
 
         if (document->on_mouse_over (x, y, x, y, redrawBoxes))
-            renderAndPaint();
+        {
+            addRedrawBoxes (redrawBoxes);
+            frameScheduler.schedule (WebView::updateStylesChanged);
+        }
     }
 
     void mouseDown(const MouseEvent& event)
@@ -612,7 +498,10 @@ struct WebView::Impl : public WebPage::ViewClient,
         std::vector<litehtml::position> redrawBoxes;
 
         if (document->on_lbutton_down (x, y, x, y, redrawBoxes))
-            renderAndPaint();
+        {
+            addRedrawBoxes (redrawBoxes);
+            frameScheduler.schedule (WebView::updateStylesChanged);
+        }
     }
 
     void mouseUp(const MouseEvent& event)
@@ -631,7 +520,10 @@ struct WebView::Impl : public WebPage::ViewClient,
         std::vector<litehtml::position> redrawBoxes;
 
         if (document->on_lbutton_up (x, y, x, y, redrawBoxes))
-            renderAndPaint();
+        {
+            addRedrawBoxes (redrawBoxes);
+            frameScheduler.schedule (WebView::updateStylesChanged);
+        }
     }
 
     void mouseWheelMove (const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel)
@@ -643,10 +535,97 @@ struct WebView::Impl : public WebPage::ViewClient,
             hScrollBar.mouseWheelMove (event, wheel);
     }
 
-    void renderAndPaint()
+    void performFrame (int reasons, int numRequests)
     {
+        // Only the restyles tell what they change, anything else may change the fixed boxes
+        if ((reasons & ~WebView::updateStylesChanged) != 0)
+            fixedLayersValid = false;
+
+        if ((reasons & (WebView::updateResized | WebView::updateDisplayChanged)) != 0)
+            updateMedia ((reasons & WebView::updateDisplayChanged) != 0);
+
         render();
         self.repaint();
+
+        if (self.onFrameUpdate)
+            self.onFrameUpdate (reasons, numRequests);
+    }
+
+    /** Re-evaluate the media queries against the current view size.
+
+        The styles get reapplied only when some media query result flips,
+        otherwise a resize costs just the layout. A display change always
+        reapplies them as the pt sizes depend on the display resolution.
+     */
+    void updateMedia (bool displayChanged)
+    {
+        if (page == nullptr)
+            return;
+
+        if (auto document { page->getDocument() })
+        {
+            if (! document->media_changed() && displayChanged)
+            {
+                document->root()->refresh_styles();
+                document->root()->parse_styles();
+            }
+        }
+    }
+
+    /** Take a snapshot of the display showing the view.
+
+        Returns true if the display metrics differ from the previous snapshot.
+     */
+    bool updateDisplayMetrics()
+    {
+        const auto& displays { Desktop::getInstance().getDisplays() };
+
+        const auto* display { self.isShowing() ? displays.getDisplayForRect (self.getScreenBounds())
+                                               : displays.getPrimaryDisplay() };
+
+        return display != nullptr
+            && renderer.setDisplayMetrics (display->dpi, display->scale, display->totalArea);
+    }
+
+    /** Schedule a relayout if the view now sits on a display with other metrics.
+
+        Dragging the window around the same display costs just the display lookup.
+     */
+    void displayMayHaveChanged()
+    {
+        if (updateDisplayMetrics())
+            frameScheduler.schedule (WebView::updateDisplayChanged);
+    }
+
+    /** Follow the top level window and its peer of the view.
+
+        Moving the window to another monitor is reported by the window, a DPI
+        or scale change by the peer. A display reconfiguration reaches the view
+        as one of those too, as the peers get moved or rescaled to the new layout.
+     */
+    void watchDisplay (Component* window, ComponentPeer* peer)
+    {
+        if (watchedWindow != window)
+        {
+            if (watchedWindow != nullptr)
+                watchedWindow->removeComponentListener (this);
+
+            watchedWindow = window;
+
+            if (window != nullptr)
+                window->addComponentListener (this);
+        }
+
+        if (watchedPeer != peer)
+        {
+            if (watchedPeer != nullptr && ComponentPeer::isValidPeer (watchedPeer))
+                watchedPeer->removeScaleFactorListener (this);
+
+            watchedPeer = peer;
+
+            if (peer != nullptr)
+                peer->addScaleFactorListener (this);
+        }
     }
 
     void followLink (const URL& url)
@@ -658,6 +637,13 @@ struct WebView::Impl : public WebPage::ViewClient,
     // WebPage::ViewClient
     void documentAboutToBeReloaded() override
     {
+        tileRenderer.invalidate();
+        renderer.clearTextRuns();
+        renderer.clearImages();
+        displayList.reset();
+        backBufferValid = false;
+        fixedLayersValid = false;
+        embeddedElements.clear();
     }
 
     void documentLoaded() override
@@ -669,7 +655,7 @@ struct WebView::Impl : public WebPage::ViewClient,
         scrollX = 0;
         scrollY = 0;
 
-        renderAndPaint();
+        frameScheduler.schedule (WebView::updateDocumentLoaded);
     }
 
     WebView* getView() override
@@ -677,6 +663,19 @@ struct WebView::Impl : public WebPage::ViewClient,
         return &self;
     }
 
+    // ComponentListener
+    void componentMovedOrResized (Component&, bool wasMoved, bool) override
+    {
+        if (wasMoved)
+            displayMayHaveChanged();
+    }
+
+    // ComponentPeer::ScaleFactorListener
+    void nativeScaleFactorChanged (double) override
+    {
+        displayMayHaveChanged();
+    }
+
     // ScrollBar::Listener
     void scrollBarMoved (ScrollBar* scrollBar, double newRangeStart) override
     {
@@ -685,6 +684,12 @@ struct WebView::Impl : public WebPage::ViewClient,
         else if (scrollBar == &hScrollBar)
             scrollX = (int)newRangeStart;
 
+        if (page != nullptr)
+        {
+            if (auto document { page->getDocument() })
+                loadNearbyImages (*document);
+        }
+
         self.repaint();
     }
 
@@ -709,6 +714,17 @@ WebPage* WebView::getPage()
     return d->page;
 }
 
+void WebView::setTiledRendering (bool shouldUseTiles, int tileSize, int prefetchMargin)
+{
+    d->setTiledRendering (shouldUseTiles, tileSize, prefetchMargin);
+}
+
+void WebView::setLazyImageLoading (bool lazyByDefault, int loadDistance)
+{
+    d->renderer.setLazyImages (lazyByDefault);
+    d->lazyImagesDistance = jmax (0, loadDistance);
+}
+
 void WebView::paint (Graphics& g)
 {
     d->paint (g);
@@ -716,7 +732,15 @@ void WebView::paint (Graphics& g)
 
 void WebView::resized()
 {
-    d->render();
+    d->renderer.setViewportSize (getWidth(), getHeight());
+    d->frameScheduler.schedule (updateResized);
+}
+
+void WebView::parentHierarchyChanged()
+{
+    // The view may have got another window, peer or display
+    d->watchDisplay (getTopLevelComponent(), getPeer());
+    d->displayMayHaveChanged();
 }
 
 void WebView::mouseMove (const MouseEvent& event)
@@ -10,15 +10,63 @@ class WebView : public juce::Component
 {
 public:
 
+    /** Reasons for the view update.
+
+        Update requests are coalesced and performed at most
+        once per display frame, these flags tell what has been
+        requested since the previous frame.
+     */
+    enum UpdateReason
+    {
+        updateResized           = 1 << 0,
+        updateImageLoaded       = 1 << 1,
+        updateStylesChanged     = 1 << 2,
+        updateDocumentLoaded    = 1 << 3,
+        updateSettingsChanged   = 1 << 4,
+        updateDisplayChanged    = 1 << 5
+    };
+
     WebView();
     ~WebView();
 
     void setPage (WebPage* page);
     WebPage* getPage();
 
+    /** Enable multi-threaded tiled rendering.
+
+        When enabled, the viewport and the prefetch margin around it
+        get split into square tiles painted in parallel on a thread pool.
+        The painted tiles are reused when scrolling until the document
+        layout changes.
+     */
+    void setTiledRendering (bool shouldUseTiles, int tileSize = 256, int prefetchMargin = 256);
+
+    /** Set the lazy images loading policy.
+
+        Images marked with loading="lazy" are only loaded once scrolled
+        within the given distance from the viewport. Until then they
+        keep the size given by their attributes or their header.
+
+        @param lazyByDefault    Load all the images lazily, except the ones
+                                marked with loading="eager".
+        @param loadDistance     Distance from the viewport to load the images at.
+
+        @note The policy applies to the documents loaded afterwards.
+     */
+    void setLazyImageLoading (bool lazyByDefault, int loadDistance = 1024);
+
+    /** Called after each performed view update.
+
+        This receives the UpdateReason flags merged into the frame
+        and the number of update requests coalesced, which can be
+        used for tracing.
+     */
+    std::function<void (int reasons, int numRequests)> onFrameUpdate{};
+
     // juce::Component
     void paint (juce::Graphics& g) override;
     void resized() override;
+    void parentHierarchyChanged() override;
 
     void mouseMove (const juce::MouseEvent& event) override;
     void mouseDown (const juce::MouseEvent& event) override;